@@ -0,0 +1,36 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef ALIAS_SAMPLER_H
+#define ALIAS_SAMPLER_H
+
+#include <vector>
+#include <random>
+#include <cstddef>
+
+// Weighted discrete sampler using Vose's alias method: O(n) to build, O(1) per draw
+class AliasSampler {
+public:
+    // Constructors
+    AliasSampler() = default;
+    explicit AliasSampler(const std::vector<double>& weights);
+
+    // Draws an index with probability proportional to its weight
+    std::size_t sample(std::mt19937& gen) const;
+
+    // Getters
+    bool isEmpty() const { return probability.empty(); }
+    std::size_t size() const { return probability.size(); }
+
+private:
+    std::vector<double> probability;  // Chance of keeping column i rather than taking its alias
+    std::vector<std::size_t> alias;
+};
+
+#endif  // ALIAS_SAMPLER_H
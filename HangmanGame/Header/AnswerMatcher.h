@@ -0,0 +1,57 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef ANSWER_MATCHER_H
+#define ANSWER_MATCHER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Precompiled set of accepted answers for one question
+class AnswerMatcher {
+public:
+    // Constructors
+    AnswerMatcher() = default;
+    explicit AnswerMatcher(const std::vector<std::string>& answers);
+
+    // Case-insensitive exact match of a raw guess against every accepted answer, in O(guess length)
+    bool matches(std::string_view guess) const;
+
+    // Getters
+    std::size_t getAnswerCount() const { return normalizedAnswers.size(); }
+    const std::vector<std::string>& getNormalizedAnswers() const { return normalizedAnswers; }  // For fuzzy matching
+
+private:
+    static constexpr std::uint32_t NO_NODE = 0xFFFFFFFF;
+
+    // Flattened trie over the case-folded answers, each node's edges are contiguous and sorted by byte
+    struct Node {
+        std::uint32_t firstEdge;
+        std::uint32_t edgeCount;
+        bool isTerminal;
+    };
+
+    struct Edge {
+        unsigned char byte;
+        std::uint32_t target;
+    };
+
+    std::string singleFoldedAnswer;  // Used instead of the trie when there are no alternates
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<std::string> normalizedAnswers;
+
+    // Private helper methods
+    void buildTrie(const std::vector<std::string>& foldedAnswers);
+    std::uint32_t step(std::uint32_t node, unsigned char byte) const;
+};
+
+#endif  // ANSWER_MATCHER_H
@@ -0,0 +1,75 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef BACKUP_SCHEDULER_H
+#define BACKUP_SCHEDULER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+/*
+Hot backups of the database while games are running. On its own connection it copies the file
+a few pages per step with a pause between steps, so a writer is never held up for more than one
+step, and each finished backup is still a consistent copy. A backup is written under a temporary
+name and renamed once complete, and only the newest few are kept.
+*/
+class BackupScheduler {
+public:
+    // Constructor and destructor
+    BackupScheduler() = default;
+    ~BackupScheduler();
+
+    // The worker thread has a single owner
+    BackupScheduler(const BackupScheduler&) = delete;
+    BackupScheduler& operator=(const BackupScheduler&) = delete;
+
+    // Job control, the first backup starts right away
+    void start(const std::string& dbPath, const std::string& backupFolder, std::chrono::minutes interval);
+    void stop();  // Cancels a backup in progress and waits for the job
+
+    // Getters
+    bool isRunning() const { return running; }
+    std::size_t getBackupCount() const { return backupCount; }
+    std::string getLastBackupPath() const;
+    std::string getError() const;  // Empty unless the last backup failed
+
+private:
+    static constexpr int PAGES_PER_STEP = 64;
+    static constexpr std::chrono::milliseconds STEP_PAUSE = std::chrono::milliseconds(10);
+    static constexpr std::size_t BACKUPS_KEPT = 5;
+
+    std::string dbPath;
+    std::string backupFolder;
+    std::chrono::minutes interval{ 0 };
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::atomic<std::size_t> backupCount{ 0 };
+
+    std::mutex stopMutex;
+    std::condition_variable stopSignal;
+    std::atomic<bool> stopRequested{ false };
+
+    mutable std::mutex resultMutex;
+    std::string lastBackupPath;
+    std::string error;
+
+    // Helpers
+    void run();
+    void takeBackup();
+    void removeOldBackups();
+    std::string getBackupName() const;  // Named by UTC time, so names sort oldest first
+};
+
+#endif  // BACKUP_SCHEDULER_H
@@ -11,18 +11,28 @@ Honors Project: Hangman
 #define DATABASE_H
 
 #include "Hangman.h"
+#include "ScoreCountTree.h"
 #include "sqlite3.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <array>
+#include <list>
+#include <functional>
+#include <tuple>
+#include <random>
+#include <chrono>
 
 // SQLite forward declarations for SQL commands, statements, queries and transactions
 struct sqlite3;
 struct sqlite3_stmt;
 
-// Forward declarations for question categories and question-answer pairs
+// Forward declarations for question categories, game modes and question-answer pairs
 enum class Category;
+enum class GameMode;
 struct QuestionAnswer;
+struct QuestionStat;
 
 // Custom exceptions for database operations
 class DatabaseException : public std::runtime_error {
@@ -30,6 +40,50 @@ public:
     explicit DatabaseException(const std::string& message) : std::runtime_error(message) { }
 };
 
+// Thrown when another connection held the lock for longer than the busy handler waits
+class DatabaseBusyException : public DatabaseException {
+public:
+    explicit DatabaseBusyException(const std::string& message) : DatabaseException(message) { }
+};
+
+// Lock contention counters, kept across open/close calls like the query profiles
+struct ContentionStats {
+    long long busyWaits = 0;           // Busy handler sleeps
+    long long busyWaitNs = 0;          // Time spent in them
+    long long maxBusyWaitNs = 0;       // Longest single wait for one lock
+    long long busyTimeouts = 0;        // Locks given up on
+    long long transactionRetries = 0;  // Writes run again after a timeout
+};
+
+// Time ranges a leaderboard can cover, DAILY and WEEKLY buckets start at 00:00 UTC (weeks on Monday)
+enum class LeaderboardWindow { ALL_TIME, DAILY, WEEKLY };
+
+// Aggregated execution statistics for one SQL statement text
+struct QueryProfile {
+    std::string sql;
+    long long executions = 0;
+    long long totalNs = 0;
+    long long maxNs = 0;
+    long long rows = 0;
+    long long fullScanSteps = 0;  // SQLITE_STMTSTATUS_FULLSCAN_STEP
+    long long sorts = 0;          // SQLITE_STMTSTATUS_SORT
+    long long autoIndexes = 0;    // SQLITE_STMTSTATUS_AUTOINDEX
+    long long vmSteps = 0;        // SQLITE_STMTSTATUS_VM_STEP
+};
+
+// One game session joined with its player, category and mode, as streamed by streamGameSessions
+struct SessionRecord {
+    long long sessionId = 0;
+    int playerId = 0;
+    std::string playerName;
+    int categoryId = 0;
+    std::string categoryName;
+    int modeId = 0;
+    std::string modeName;
+    int scoreCenti = 0;      // Score in centi-points
+    long long playedAt = 0;  // Unix time in seconds
+};
+
 // Database class declaration
 class Database {
 public:
@@ -40,32 +94,87 @@ public:
     Database(const Database&) = delete;
     Database& operator=(const Database&) = delete;
 
+    // Database in memory shared by every connection of the process, it is discarded when the last one closes
+    static const std::string MEMORY_DB_PATH;
+
     // Database initialization
     void initialize(const std::string& dbPath);
+    void initializeShard(const std::string& dbPath, Category category);  // Same tables, only the category's questions
+    void initializeInMemory(const std::string& snapshotPath);  // Loads the snapshot or seeds from the TSVs, stays open
     bool databaseExists(const std::string& dbPath) const;
     void createTables();
+    void upgradeSchema();
 
     // Connection management
-    void open(const std::string& dbPath);
+    void open(const std::string& dbPath, bool readOnly = false);
     void close();
     bool isOpen() const;
+    void enableWriteAheadLog();  // Persistent for the file, readers then never wait on the writer
+    bool isInMemory() const;
+
+    // Whole-database copies, each one a consistent point in time
+    void saveSnapshot(const std::string& filePath);  // Replaces the file with this database, nothing else may have it open for writing
+    void loadSnapshot(const std::string& filePath);  // Fills this empty database with the file's contents
+
+    // Online backup to filePath, pagesPerStep pages at a time (-1 for all) with a pause after each step, so writers
+    // are only held up for the length of one step. onStep gets the pages left and the total and returns false to
+    // cancel. Returns false when cancelled, the file is then left incomplete.
+    bool backupTo(const std::string& filePath, int pagesPerStep, std::chrono::milliseconds pause, const std::function<bool(int, int)>& onStep = nullptr);
 
     // Data loading operations
+    void loadAllQuestionFiles();
     void loadQuestionsFromTSV(const std::string& filePath, const std::string& category);
     std::vector<QuestionAnswer> getQuestions(Category category);
 
+    // Question statistics
+    void saveQuestionStats(const std::vector<QuestionStat>& stats);
+    long long getTimesAsked(Category category);  // Questions asked in the category over all games, grows with every game
+
     // Player operations
     int addPlayer(const std::string& playerName);
     bool playerExists(const std::string& playerName);
     int getPlayerId(const std::string& playerName);
+    double getAverageScore(int playerId);  // Mean score over all of the player's sessions, -1 without history
+    std::pair<long long, long long> getScoreTotals(int playerId);  // Sum of centi-points and number of sessions
+    void importPlayer(const std::string& playersDbPath, int playerId);  // Copies a player from a shared players file, keeping the ID
 
     // Score operations
-    void saveScore(int playerId, const std::string& category, const std::string& mode, double score);
+    void saveScore(int playerId, Category category, GameMode mode, int scoreCenti);
     void updateHighScores(int sessionId, int categoryId, int modeId);
-    double getHighScore(int playerId, const std::string& category, const std::string& mode);
-    std::vector<std::string> getHighScores(const std::string& category, const std::string& mode);
-    std::vector<std::pair<std::string, double>> getTopScores(const std::string& category, const std::string& mode, int limit = 10);
+    int getScoreRank(int categoryId, int modeId, int scoreCenti);
+    void refreshLeaderboard(int categoryId, int modeId);
+    std::size_t rebuildHighScores(const std::function<void(std::size_t, std::size_t)>& onProgress = nullptr);  // Sessions read and total, returns sessions read
+    void updatePlayerBest(int playerId, Category category, GameMode mode, int scoreCenti);
+    void updateWindowedScores(int sessionId, int categoryId, int modeId);
+    int getHighScoreCenti(int playerId, Category category, GameMode mode);  // 0 without a top 10 score
+    int getScoreRank(Category category, GameMode mode, int scoreCenti);  // 1 + sessions with a higher score, from Score_Histogram
+
+    // Player standings over each player's best score, for any player rather than only the top 10
+    int getPlayerRank(int playerId, Category category, GameMode mode);  // 1 + players with a higher best, -1 without sessions
+    double getPercentile(int scoreCenti, Category category, GameMode mode);  // Share of players below, ties count half, 0 to 100
+    std::vector<std::string> getHighScores(Category category, GameMode mode, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);
+    std::vector<std::pair<std::string, int>> getTopScores(Category category, GameMode mode, int limit = 10, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);  // Scores in centi-points
+
+    // Retention: rolls up to maxSessions of the oldest sessions past the retention period into Session_Rollups,
+    // sessions referenced by a leaderboard are kept, returns the number rolled up (0 once nothing is left)
+    std::size_t compactSessions(int retentionDays, std::size_t maxSessions);
+    int incrementalVacuum(int pageCount);  // Frees up to pageCount unused pages, returns the number still free
+
+    // Bulk export: hands Game_Sessions to onChunk in session_id order, at most chunkSize rows at a time
+    std::size_t streamGameSessions(const std::function<void(const std::vector<SessionRecord>&)>& onChunk, std::size_t chunkSize = 4096);
+
+    // Query profiling (statistics are kept across open/close calls)
+    void setQueryProfiling(bool enabled);
+    bool isQueryProfilingEnabled() const { return queryProfilingEnabled; }
+    std::vector<QueryProfile> getQueryProfiles() const;  // Sorted by total execution time, slowest first
+    std::string getQueryProfileReport() const;
+    void resetQueryProfiles();
 
+    // Lock contention statistics (also kept across open/close calls)
+    const ContentionStats& getContentionStats() const { return contentionStats; }
+    void resetContentionStats() { contentionStats = ContentionStats(); }
+
+    void mergeStatistics(const Database& other);  // Adds another connection's query profiles and contention counters to this one
     // Destructor
     ~Database();
 
@@ -77,20 +186,97 @@ private:
         "CSC_231.tsv"
     };
 
+    // Sessions read between rebuildHighScores progress reports
+    static constexpr std::size_t REBUILD_PROGRESS_INTERVAL = 65536;
+
+    // Busy handler backoff: jittered delays doubling from the base up to the cap, until the timeout
+    static constexpr std::chrono::microseconds BUSY_BASE_DELAY = std::chrono::microseconds(1000);
+    static constexpr std::chrono::microseconds BUSY_MAX_DELAY = std::chrono::microseconds(20000);
+    static constexpr std::chrono::milliseconds BUSY_TIMEOUT = std::chrono::milliseconds(5000);
+    static constexpr int WRITE_ATTEMPTS = 3;  // Tries of a timed out write before it is given up on
+
+    // Windowed leaderboard buckets kept before expiry
+    static constexpr long long SECONDS_PER_DAY = 86400;
+    static constexpr int DAILY_BUCKETS_KEPT = 14;
+    static constexpr int WEEKLY_BUCKETS_KEPT = 8;
+
+    // Number of values in the Category and GameMode enums
+    static constexpr int CATEGORY_COUNT = 3;
+    static constexpr int MODE_COUNT = 2;
+
     sqlite3* db;
     std::string currentDbPath;
 
+    // Row IDs of the Categories and Game_Modes reference tables, indexed by enum value
+    std::array<int, CATEGORY_COUNT> categoryIds;
+    std::array<int, MODE_COUNT> modeIds;
+    bool referenceIdsLoaded;
+
+    // LRU cache of player name to player ID, most recently used at the front
+    static constexpr std::size_t PLAYER_CACHE_CAPACITY = 64;
+    using PlayerCacheList = std::list<std::pair<std::string, int>>;
+    PlayerCacheList playerCache;
+    std::unordered_map<std::string, PlayerCacheList::iterator> playerCacheIndex;
+
+    // Counting trees of player best scores per category-mode, loaded from Player_Best_Histogram on first use after open
+    static constexpr int MAX_SCORE_CENTI = 10000;
+    std::array<ScoreCountTree, CATEGORY_COUNT * MODE_COUNT> playerBestTrees;
+    std::array<bool, CATEGORY_COUNT * MODE_COUNT> playerBestTreesLoaded;
+    int playerBestDataVersion;  // PRAGMA data_version the trees were loaded at, other connections' commits change it
+
+    // Lock contention state
+    ContentionStats contentionStats;
+    std::mt19937 backoffRandom;
+    std::chrono::steady_clock::time_point busyWaitStart;  // First busy callback for the current lock
+
+    // Query profiling state
+    bool queryProfilingEnabled;
+    std::unordered_map<std::string, QueryProfile> queryProfiles;  // Keyed by the statement's SQL text
+
     // Helper functions
     int executeQuery(const std::string& query);
     bool tableExists(const std::string& tableName);
+    bool columnExists(const std::string& tableName, const std::string& columnName);
+    int getPragmaInt(const std::string& pragmaName);
     void beginTransaction();
     void commitTransaction();
     void rollbackTransaction();
+    void saveScoreTransaction(int playerId, Category category, GameMode mode, int scoreCenti);
+    void saveQuestionStatsTransaction(const std::vector<QuestionStat>& stats);
+
+    // Reference ID lookups
+    void loadReferenceIds();
+    int getCategoryId(Category category);
+    int getModeId(GameMode mode);
+
+    // Player ID cache
+    int findCachedPlayerId(const std::string& playerName);  // Returns -1 on a miss
+    void cachePlayerId(const std::string& playerName, int playerId);
+    void clearPlayerCache();
+
+    // Player best score trees
+    ScoreCountTree& getPlayerBestTree(Category category, GameMode mode);
+
+    // Windowed leaderboards
+    static long long getWindowStart(LeaderboardWindow window, long long unixTime);
+    std::vector<std::tuple<std::string, int, int>> getWindowedScores(Category category, GameMode mode, LeaderboardWindow window, int limit);  // Name, centi-points, tie count
 
     // Statement preparation
     using StmtPtr = std::unique_ptr<sqlite3_stmt, decltype(&sqlite3_finalize)>;
     StmtPtr prepareStatement(const std::string& query);
 
+    // Query profiling helpers
+    void registerTrace();
+    static int traceCallback(unsigned int type, void* context, void* p, void* x);
+
+    // Lock contention
+    static int busyCallback(void* context, int priorCalls);
+    void retryOnBusy(const std::function<void()>& write);
+    std::chrono::microseconds getBackoffDelay(int attempt);
+
+    // Snapshots
+    sqlite3* openSnapshotFile(const std::string& filePath, bool create);  // Plain handle, closed by the caller
+
     // Error handling
     void checkError(int result, const std::string& operation);
     std::string getLastError() const;
@@ -98,6 +284,7 @@ private:
     // Utility functions
     void bindText(sqlite3_stmt* stmt, int index, const std::string& value);
     void bindInt(sqlite3_stmt* stmt, int index, int value);
+    void bindInt64(sqlite3_stmt* stmt, int index, long long value);
     void bindDouble(sqlite3_stmt* stmt, int index, double value);
 };
 
@@ -13,10 +13,16 @@ Honors Project: Hangman
 #include <iostream>
 #include <string>
 #include <vector>
+#include <functional>
 
 // Forward declarations of classes used
 class Database;
+class SharedDatabase;
+class ShardedDatabase;
 class Hangman;
+enum class LeaderboardWindow;
+enum class Category;
+enum class GameMode;
 
 class Display {
 public:
@@ -29,13 +35,15 @@ public:
     static void showModeMenu();
     static void showCategoryMenu();
     static void showAbout();
-    static void showHighScores(Database& db);
+    static void showHighScores(Database& db, LeaderboardWindow window);
+    static void showHighScores(SharedDatabase& db, LeaderboardWindow window);
+    static void showHighScores(ShardedDatabase& db, LeaderboardWindow window);
 
     // Game state displays
     static void showClassicGameState(const Hangman& game);
     static void showTestGameState(const Hangman& game);
     static void showGuessResult(bool correct);
-    static void showGameOver(const Hangman& game);
+    static void showGameOver(const Hangman& game, int playerRank = -1, double percentile = -1.0);
 
     // Prompts and confirmations
     static void showPlayerNamePrompt();
@@ -75,6 +83,7 @@ private:
     static void setTextColor(const std::string& color);
     static void resetTextColor();
     static std::string generateHangmanStage(int incorrectGuesses);
+    static void showHighScoreTables(LeaderboardWindow window, const std::function<std::vector<std::string>(Category, GameMode)>& getScores);
 };
 
 #endif  // DISPLAY_H
@@ -66,4 +66,13 @@ public:
     virtual ~Game() = default;
 };
 
+// Abstract base class for quiz-style games, which are played by submitting guesses
+class QuizGame : public Game {
+protected:
+    using Game::Game;
+
+public:
+    virtual bool makeGuess(const std::string& guess) = 0;
+};
+
 #endif  // GAME_H
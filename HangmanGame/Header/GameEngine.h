@@ -0,0 +1,62 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+
+#include "Game.h"
+#include <string>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/*
+Host loop for quiz games. With a final game class such as Hangman, isGameOver and makeGuess
+are resolved at compile time and can be inlined, which suits simulation and replay loops.
+With QuizGame itself, for games created through GameRegistry, the same loop uses virtual calls.
+*/
+template <typename GameT>
+class GameEngine {
+    static_assert(std::is_base_of<QuizGame, GameT>::value, "GameEngine needs a QuizGame");
+
+public:
+    explicit GameEngine(GameT& game) : game(game) { }
+
+    // Feeds guesses until the game is over or nextGuess returns nullptr, returns the number of guesses made
+    template <typename GuessSource>
+    std::size_t run(GuessSource&& nextGuess) {
+        return run(std::forward<GuessSource>(nextGuess), [](bool) { });
+    }
+
+    // Same, with onResult told whether each guess was correct. A guess the game rejects throws out of run
+    // and counts for nothing, calling run again carries on with the same game.
+    template <typename GuessSource, typename ResultSink>
+    std::size_t run(GuessSource&& nextGuess, ResultSink&& onResult) {
+        std::size_t guessCount = 0;
+
+        while (!game.isGameOver()) {
+            const std::string* guess = nextGuess();
+
+            if (guess == nullptr) break;
+
+            onResult(game.makeGuess(*guess));
+            guessCount++;
+        }
+
+        return guessCount;
+    }
+
+    // Getters
+    GameT& getGame() { return game; }
+
+private:
+    GameT& game;
+};
+
+#endif  // GAME_ENGINE_H
@@ -0,0 +1,121 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef GAME_LOG_H
+#define GAME_LOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+
+class Hangman;
+struct QuestionAnswer;
+enum class Category;
+enum class GameMode;
+
+// Event types stored in the log
+enum class GameEventType : std::uint8_t { START_GAME = 1, GUESS = 2, END_GAME = 3, RESET_GAME = 4, SCORE_SAVED = 5 };
+
+// Custom exception for event log failures
+class GameLogException : public std::runtime_error {
+public:
+    explicit GameLogException(const std::string& message) : std::runtime_error(message) { }
+};
+
+// One game rebuilt from its logged events
+struct LoggedGame {
+    std::uint64_t gameId = 0;
+    long long startedAt = 0;  // Unix milliseconds
+    int playerId = -1;
+    Category category{};
+    GameMode mode{};
+    std::vector<int> questionIds;  // In the order they were asked
+    std::vector<std::string> guesses;
+    bool isFinished = false;   // END_GAME was logged
+    bool isAbandoned = false;  // The player quit, RESET_GAME was logged
+    bool isScoreSaved = false; // SCORE_SAVED was logged, or END_GAME by a version that never logs it
+    bool tracksScoreSaved = false;  // START_GAME promised a SCORE_SAVED once the score is in the database
+    int loggedScoreCenti = 0;  // Score recorded by END_GAME
+};
+
+// Score recomputed by replaying a logged game through the current rules
+struct ReplayResult {
+    LoggedGame game;
+    int replayedScoreCenti = 0;
+    std::string error;  // Why the game could not be replayed, empty when it was
+};
+
+/*
+Log file layout (all integers little-endian):
+    Header: "HGEL", u32 version
+    Events: u8 type, u32 payload length, u64 game ID, i64 Unix milliseconds, payload, u32 checksum
+        START_GAME:  i32 player ID, u8 category, u8 mode, u16 count, i32 question IDs[count], u8 flags
+        GUESS:       u8 correct, u16 length, guess bytes
+        END_GAME:    u32 score in centi-points
+        RESET_GAME:  empty
+        SCORE_SAVED: empty, the score is in the database
+Flags bit 0 says SCORE_SAVED is logged for the game, older logs have no flags byte.
+The checksum is 32-bit FNV-1a over the event bytes before it. Reading stops at the first
+incomplete or corrupt event, which is where a crash mid-write leaves the file.
+*/
+class GameLog {
+public:
+    // Constructors and destructor
+    GameLog() = default;
+    ~GameLog();
+
+    // The open file has a single owner
+    GameLog(const GameLog&) = delete;
+    GameLog& operator=(const GameLog&) = delete;
+
+    // Log file operations
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    void sync();  // Forces buffered events to disk
+
+    // Writers, each event is flushed to the OS immediately and fsynced periodically
+    void appendStartGame(int playerId, Category category, GameMode mode, const std::vector<int>& questionIds);
+    void appendGuess(const std::string& guess, bool correct);
+    void appendEndGame(int scoreCenti);
+    void appendResetGame();
+    void appendScoreSaved();
+    void appendEndGame(std::uint64_t gameId, int scoreCenti);  // Closes a game another process left unfinished
+    void appendScoreSaved(std::uint64_t gameId);               // Same, for a score that process never saved
+
+    // Readers
+    static std::vector<LoggedGame> readGames(const std::string& path);
+    static void replayGame(const LoggedGame& game, Hangman& hangman);  // hangman must hold the game's category bank
+    // Games that cannot be replayed are kept with their error and the rest still replay
+    static std::vector<ReplayResult> replayScores(const std::string& path, const std::map<Category, std::vector<QuestionAnswer>>& banks, Hangman& hangman);
+
+private:
+    static constexpr std::uint32_t LOG_VERSION = 1;
+    static constexpr std::uint8_t SCORE_SAVED_FLAG = 1;
+    static constexpr int SYNC_EVENT_INTERVAL = 32;  // Events between forced syncs
+    static constexpr std::chrono::milliseconds SYNC_INTERVAL = std::chrono::milliseconds(1000);
+
+    std::FILE* file = nullptr;
+    std::string filePath;
+    std::uint64_t currentGameId = 0;
+    int eventsSinceSync = 0;
+    std::chrono::steady_clock::time_point lastSyncTime;
+
+    // Helpers
+    void appendEvent(GameEventType type, const std::string& payload, bool forceSync);
+    static void appendLE(std::string& out, std::uint64_t value, int byteCount);
+    static std::uint64_t readLE(const unsigned char* bytes, int byteCount);
+    static std::uint32_t fnv1a(const unsigned char* bytes, std::size_t count);
+};
+
+#endif  // GAME_LOG_H
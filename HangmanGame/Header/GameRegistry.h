@@ -0,0 +1,38 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef GAME_REGISTRY_H
+#define GAME_REGISTRY_H
+
+#include "Game.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+
+// Creates a new instance of a registered game
+using GameFactory = std::function<std::unique_ptr<QuizGame>()>;
+
+// Name-to-factory table for the quiz games the host can run, built-in games are registered on first use
+class GameRegistry {
+public:
+    // Registration is meant for startup, before games are created from other threads
+    static void registerGame(const std::string& name, GameFactory factory);
+    static std::unique_ptr<QuizGame> create(const std::string& name);
+
+    // Getters
+    static bool isRegistered(const std::string& name);
+    static std::vector<std::string> getGameNames();
+
+private:
+    static std::map<std::string, GameFactory>& getFactories();
+};
+
+#endif  // GAME_REGISTRY_H
@@ -12,23 +12,57 @@ Honors Project: Hangman
 
 #include "Game.h"
 #include "Database.h"
+#include "AnswerMatcher.h"
+#include "AliasSampler.h"
 #include <string>
 #include <vector>
 #include <random>
 #include <chrono>
+#include <array>
+#include <unordered_map>
+#include <memory>
+
+class GameLog;
+class QuestionBank;
 
 // Enums for game states and modes
 enum class GameState { MENU, PLAYING, PAUSED, GAME_OVER };
 enum class GameMode { CLASSIC, TEST };
 enum class Category { CSC_111, CSC_211, CSC_231 };
+enum class SelectionPolicy { UNIFORM, ADAPTIVE };
 
 // Struct to hold a question-answer pair
 struct QuestionAnswer {
+    int id;  // Questions.question_id, or -1 when the question did not come from the database
     std::string question;
     std::string answer;
+    std::vector<std::string> alternateAnswers;  // Other accepted spellings of the answer
+    AnswerMatcher matcher;  // Compiled from all accepted answers once, when the question is loaded
+    double difficulty;  // 0 (always answered) to 1 (never answered), 0.5 without history
     bool used;  // Track if question-answer pair has been used in current game
 
-    QuestionAnswer(std::string q, std::string a) : question(std::move(q)), answer(std::move(a)), used(false) { }
+    QuestionAnswer(std::string q, std::string a, std::vector<std::string> alternates = {}, int questionId = -1)
+        : id(questionId), question(std::move(q)), answer(std::move(a)), alternateAnswers(std::move(alternates)), difficulty(0.5), used(false) {
+        std::vector<std::string> accepted = { answer };
+        accepted.insert(accepted.end(), alternateAnswers.begin(), alternateAnswers.end());
+
+        matcher = AnswerMatcher(accepted);
+    }
+};
+
+// Per-question play counters, accumulated during play and flushed to the Question_Stats table
+struct QuestionStat {
+    int questionId = -1;
+    int timesAsked = 0;
+    int timesCorrect = 0;
+    int totalGuesses = 0;
+    long long totalAnswerMs = 0;  // Time from the question being shown to the round ending
+};
+
+// Answer matching settings, configurable per game mode
+struct AnswerMatchSettings {
+    bool allowTypos = false;  // Accept near-miss spellings after normalizing whitespace and punctuation
+    int maxTypos = 2;         // Upper bound on edits, short answers get fewer (see Hangman::getTypoBudget)
 };
 
 // Custom exceptions for Hangman game
@@ -37,14 +71,15 @@ public:
     explicit HangmanException(const std::string& message) : GameException(message) { }
 };
 
-// Derived class for Hangman game
-class Hangman : public Game {
+// Derived class for Hangman game, final so template hosts call it without virtual dispatch
+class Hangman final : public QuizGame {
 public:
     // Constructor
     Hangman();
 
     // Game interface implementation
     bool startGame() override;
+    bool startGameWithQuestions(const std::vector<int>& questionIds);  // Replays a logged game's question order
     bool isGameOver() const override;
     void endGame() override;
     void resetGame() override;
@@ -57,24 +92,36 @@ public:
     const QuestionAnswer& getCurrentQuestion() const;
 
     int getCurrentRound() const { return currentRound; }
-    double getCurrentScore() const { return currentScore; }
+    double getCurrentScore() const { return currentScore / 100.0; }
+    int getCurrentScoreCenti() const { return currentScore; }
     int getIncorrectRounds() const { return incorrectRounds; }
     int getIncorrectGuesses() const { return incorrectGuesses; }
     int getRemainingChances() const;
     std::chrono::seconds getRemainingTime() const;
     bool getHasPlayerWon() const;
     bool isNewHighScore() const;
-
+    SelectionPolicy getSelectionPolicy() const { return selectionPolicy; }
+    double getPlayerSkill() const { return playerSkill; }
+    std::vector<int> getQuestionIds() const;
+    GameLog* getEventLog() const { return eventLog; }
 
     // Setters
     void setGameMode(GameMode mode);
     void setCategory(Category cat);
     void setCurrentDbPath(const std::string& path) { currentDbPath = path; }
     void setCurrentPlayerId(int id) { currentPlayerId = id; }
+    void setSelectionPolicy(SelectionPolicy policy) { selectionPolicy = policy; }
+    void setPlayerSkill(double skill);  // 0 (weakest) to 1 (strongest)
+    void resetPlayer();  // Back to an anonymous player of average skill
+    void setEventLog(GameLog* log) { eventLog = log; }  // Not owned, nullptr disables logging
+    void setAnswerMatching(GameMode mode, const AnswerMatchSettings& settings);
+    const AnswerMatchSettings& getAnswerMatching(GameMode mode) const;
     
     // Hangman operations
     bool loadQuestions(const std::vector<QuestionAnswer>& questions);
-    bool makeGuess(const std::string& guess);
+    bool loadQuestions(std::shared_ptr<const QuestionBank> bank);  // Questions are read from the mapped bank only when drawn
+    bool makeGuess(const std::string& guess) override;
+    std::vector<QuestionStat> takeQuestionStats();  // Returns and clears the counters recorded since the last call
 
     // Static helper functions
     static std::string categoryToString(Category cat);
@@ -85,34 +132,64 @@ public:
 
 private:
     static constexpr int TOTAL_ROUNDS = 10;
-    static constexpr double MAX_SCORE = 100.0;
+    static constexpr int MAX_SCORE = 10000;  // 100.00 points, scores are kept in centi-points
     static constexpr int MAX_CLASSIC_QUESTION_CHANCES = 5;  // 5 attempts per round in Classic mode
     static constexpr int SECONDS_PER_TEST_QUESTION = 120;   // 2 minutes per round in Test mode
-    static constexpr double POINTS_PER_ROUND = MAX_SCORE / TOTAL_ROUNDS;  // 10.00 points per round
-    static constexpr double POINTS_PER_ATTEMPT = POINTS_PER_ROUND / MAX_CLASSIC_QUESTION_CHANCES;  // 2.00 points per attempt in Classic mode rounds
+    static constexpr int POINTS_PER_ROUND = MAX_SCORE / TOTAL_ROUNDS;  // 10.00 points per round
+    static constexpr int POINTS_PER_ATTEMPT = POINTS_PER_ROUND / MAX_CLASSIC_QUESTION_CHANCES;  // 2.00 points per attempt in Classic mode rounds
+    static constexpr std::size_t MAX_GUESS_LENGTH = 200;  // Arbitrary max length of a guess
+    static constexpr std::size_t ANSWER_CHARS_PER_TYPO = 4;  // Answers need 4 characters per allowed typo
+    static constexpr int SKILL_LEVELS = 5;                  // Adaptive selection keeps one alias table per skill level
+    static constexpr double DIFFICULTY_SPREAD = 0.2;        // Width of the difficulty band favoured at each skill level
+    static constexpr double MIN_QUESTION_WEIGHT = 0.05;     // Keeps every question reachable
+    static constexpr double SKILL_SMOOTHING = 0.3;          // Weight of the latest game in the running skill estimate
+    static constexpr double DEFAULT_PLAYER_SKILL = 0.5;     // Skill assumed for a player without history
+    static constexpr int MAX_SAMPLING_ATTEMPTS = 1000;      // Draws before falling back to uniform selection
 
     GameState currentState;
     GameMode currentMode;
     Category currentCategory;
-    std::vector<QuestionAnswer> fullQuestionBank;   // All questions for current category
+    // The current category's questions come from one of these, a full QuestionAnswer is only built when drawn
+    std::vector<QuestionAnswer> loadedQuestions;    // Questions passed to loadQuestions, empty for a mapped bank
+    std::shared_ptr<const QuestionBank> mappedBank;
+    std::vector<std::size_t> drawnIndices;          // Pool positions already in the question set
     std::vector<QuestionAnswer> questionSet;        // Current game's question set
     std::string currentDbPath;
 
     int currentRound;
-    double currentScore;
+    int currentScore;  // Centi-points, so scores compare exactly
     int incorrectRounds;
     int incorrectGuesses;
     int remainingChances;
     std::chrono::seconds timeLimit;
     std::chrono::steady_clock::time_point gameStartTime;
+    std::chrono::steady_clock::time_point roundStartTime;
+    int roundGuesses;
     int currentPlayerId;
     bool hasPlayerWon;
+    std::array<AnswerMatchSettings, 2> answerMatching;  // Indexed by GameMode
+    std::unordered_map<int, QuestionStat> pendingQuestionStats;  // Keyed by question ID
+    SelectionPolicy selectionPolicy;
+    double playerSkill;
+    std::array<AliasSampler, SKILL_LEVELS> difficultySamplers;  // Built lazily per bank load
+    GameLog* eventLog;
 
     // Private member functions
     void initializeGame();
     void selectRandomQuestions();
+    void selectQuestionsById(const std::vector<int>& questionIds);
+    void drawQuestion(std::size_t index);  // Adds a pool entry to the question set
+    bool isDrawn(std::size_t index) const;
+    std::size_t getPoolSize() const;
+    int getPoolId(std::size_t index) const;
+    double getPoolDifficulty(std::size_t index) const;
+    void beginRounds();
+    const AliasSampler& getDifficultySampler();
     bool validateGuess(const std::string& guess) const;
+    bool isAnswerMatch(const std::string& guess, const QuestionAnswer& qa) const;
+    int getTypoBudget(const std::string& normalizedAnswer) const;
     void updateScore(bool correct);
+    void recordRoundResult(const QuestionAnswer& qa, bool correct);
     bool isTimeExpired() const;
 };
 
@@ -0,0 +1,91 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Output formats for the recorded timings
+enum class ProfileFormat { JSON, CHROME_TRACE };
+
+// A single completed timing sample
+struct ProfileSample {
+    const char* name;           // Phase name (must be a string literal)
+    std::uint64_t startNs;      // Start time relative to the profiler epoch
+    std::uint64_t durationNs;   // Elapsed time of the phase
+    std::uint32_t threadId;     // Small sequential id of the recording thread
+};
+
+// Lightweight phase profiler backed by a fixed-size ring buffer
+class Profiler {
+public:
+    // Setup
+    static void enable(ProfileFormat format, const std::string& outputPath);
+    static void disable();
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Recording
+    static void record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    // Output
+    static std::string toJSON();
+    static std::string toChromeTrace();
+    static void dump();  // Writes the samples to the configured output path in the configured format
+
+private:
+    static constexpr std::size_t RING_CAPACITY = 4096;  // Oldest samples are overwritten once full
+
+    static std::atomic<bool> enabled;
+    static std::atomic<std::uint64_t> nextSlot;
+    static std::array<ProfileSample, RING_CAPACITY> ring;
+    static std::chrono::steady_clock::time_point epoch;
+    static ProfileFormat outputFormat;
+    static std::string outputPath;
+
+    // Private helper methods
+    static std::uint32_t currentThreadId();
+    static std::size_t collectSamples(std::array<ProfileSample, RING_CAPACITY>& samples);
+};
+
+// RAII timer that records the lifetime of its scope, only reads the clock while profiling is enabled
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* phaseName) : name(phaseName), active(Profiler::isEnabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        if (active) Profiler::record(name, start, std::chrono::steady_clock::now());
+    }
+
+private:
+    const char* name;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Define HANGMAN_DISABLE_PROFILING to compile every timer out entirely
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef HANGMAN_DISABLE_PROFILING
+    #define PROFILE_SCOPE(name) ((void)0)
+#else
+    #define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(name)
+#endif
+
+#endif  // PROFILER_H
@@ -0,0 +1,99 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef QUESTION_BANK_H
+#define QUESTION_BANK_H
+
+#include "Hangman.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+// Custom exception for question bank failures
+class QuestionBankException : public std::runtime_error {
+public:
+    explicit QuestionBankException(const std::string& message) : std::runtime_error(message) { }
+};
+
+// Read-only view of one question inside a mapped bank, valid while the bank stays open
+struct QuestionView {
+    int id;                      // -1 when the bank was compiled without database IDs
+    double difficulty;           // 0.5 when the bank was compiled without play history
+    std::string_view question;
+    std::string_view answer;
+    std::string_view alternates; // Tab-separated, empty without alternates
+};
+
+/*
+Bank file layout (all integers little-endian):
+    Header:  "HGQB", u32 version, u32 question count, u32 times asked, u64 blob size, u32 checksum, u32 reserved
+    Records: per question: i32 id, u32 difficulty in millionths, then u32 offset and u32 length for question,
+             answer and alternates
+    Blob:    all strings back to back, offsets are relative to the start of the blob
+The checksum is 32-bit FNV-1a over the records and the blob. Times asked is the category's total when the
+difficulties were taken (modulo 2^32), so a bank whose difficulties fell behind the play history can be found.
+*/
+class QuestionBank {
+public:
+    // Constructors and destructor
+    QuestionBank() = default;
+    ~QuestionBank();
+
+    // Mapped memory has a single owner
+    QuestionBank(const QuestionBank&) = delete;
+    QuestionBank& operator=(const QuestionBank&) = delete;
+    QuestionBank(QuestionBank&& other) noexcept;
+    QuestionBank& operator=(QuestionBank&& other) noexcept;
+
+    // Bank compilation
+    static void compile(const std::vector<QuestionAnswer>& questions, const std::string& path, long long timesAsked = 0);
+    static void compileFromTSV(const std::string& tsvPath, const std::string& path);
+
+    // Mapping only checks the header and sizes, pages are read as questions are used and string offsets are
+    // checked on every read. verifyChecksum reads the whole file, which is left to callers that want it.
+    void open(const std::string& path);
+    void close();
+    bool verifyChecksum() const;
+
+    // Getters
+    bool isOpen() const { return data != nullptr; }
+    std::size_t size() const { return questionCount; }
+    std::uint32_t getTimesAsked() const;
+    QuestionView getQuestion(std::size_t index) const;
+    int getQuestionId(std::size_t index) const;  // Reads the ID alone, without touching the strings
+    double getDifficulty(std::size_t index) const;  // Same, for the difficulty
+
+    // Copies one question into the form the game plays, done only for the questions drawn
+    QuestionAnswer getQuestionAnswer(std::size_t index) const;
+
+private:
+    static constexpr std::uint32_t BANK_VERSION = 2;
+    static constexpr std::size_t HEADER_SIZE = 32;
+    static constexpr std::size_t RECORD_SIZE = 32;
+    static constexpr double DIFFICULTY_SCALE = 1000000.0;
+
+    const unsigned char* data = nullptr;
+    std::size_t length = 0;
+    std::size_t questionCount = 0;
+    const unsigned char* records = nullptr;
+    const unsigned char* blob = nullptr;
+    std::size_t blobSize = 0;
+
+    // Helpers
+    std::string_view getString(const unsigned char* field) const;
+    static std::uint32_t readLE32(const unsigned char* bytes);
+    static std::uint64_t readLE64(const unsigned char* bytes);
+    static void appendLE(std::string& out, std::uint64_t value, int byteCount);
+    static std::uint32_t fnv1a(const unsigned char* bytes, std::size_t count, std::uint32_t hash = 2166136261u);
+};
+
+#endif  // QUESTION_BANK_H
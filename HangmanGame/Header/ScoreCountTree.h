@@ -0,0 +1,40 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SCORE_COUNT_TREE_H
+#define SCORE_COUNT_TREE_H
+
+#include <vector>
+
+// Fenwick tree of counts over the integer scores 0..maxScore: O(log n) updates and "how many below/above" queries
+class ScoreCountTree {
+public:
+    // Constructors
+    ScoreCountTree() = default;
+    explicit ScoreCountTree(int maxScore);
+
+    // Tree operations
+    void add(int score, long long delta);
+    long long countBelow(int score) const;  // Entries with a score strictly lower
+    long long countAbove(int score) const;  // Entries with a score strictly higher
+    long long countAt(int score) const;
+
+    // Getters
+    bool isEmpty() const { return tree.empty(); }
+    long long getTotal() const { return total; }
+    int getMaxScore() const { return static_cast<int>(tree.size()) - 2; }
+
+private:
+    std::vector<long long> tree;  // 1-based, slot score + 1 holds the score's partial sum
+    long long total = 0;
+
+    long long prefixSum(int score) const;  // Entries with a score of at most score
+};
+
+#endif  // SCORE_COUNT_TREE_H
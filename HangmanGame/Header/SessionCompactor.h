@@ -0,0 +1,63 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SESSION_COMPACTOR_H
+#define SESSION_COMPACTOR_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+
+/*
+Background retention job. On its own connection it rolls Game_Sessions rows older than the
+retention period into Session_Rollups a batch at a time, then hands the freed pages back to
+the file system with incremental vacuum steps. Each step is a short transaction followed by
+a pause, so the game's connection only ever waits briefly for the lock.
+*/
+class SessionCompactor {
+public:
+    // Constructor and destructor
+    SessionCompactor() = default;
+    ~SessionCompactor();
+
+    // The worker thread has a single owner
+    SessionCompactor(const SessionCompactor&) = delete;
+    SessionCompactor& operator=(const SessionCompactor&) = delete;
+
+    // Job control
+    void start(const std::string& dbPath, int retentionDays);
+    void stop();  // Asks the job to stop after its current step and waits for it
+
+    // Getters
+    bool isRunning() const { return running; }
+    std::size_t getCompactedCount() const { return compactedCount; }
+    std::string getError() const;  // Empty unless the job failed
+
+private:
+    static constexpr std::size_t BATCH_SIZE = 500;         // Sessions per compaction transaction
+    static constexpr int VACUUM_PAGES_PER_STEP = 64;
+    static constexpr std::chrono::milliseconds STEP_PAUSE = std::chrono::milliseconds(50);
+
+    std::thread worker;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> running{ false };
+    std::atomic<std::size_t> compactedCount{ 0 };
+
+    mutable std::mutex errorMutex;
+    std::string error;
+
+    // Helpers
+    void run(const std::string& dbPath, int retentionDays);
+    bool pause();  // Sleeps between steps, returns false once a stop was requested
+};
+
+#endif  // SESSION_COMPACTOR_H
@@ -0,0 +1,60 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SESSION_EXPORTER_H
+#define SESSION_EXPORTER_H
+
+#include "Database.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cstdint>
+
+// Output formats for exported game sessions
+enum class ExportFormat { CSV, COLUMNAR };
+
+// Custom exception for export failures
+class ExportException : public std::runtime_error {
+public:
+    explicit ExportException(const std::string& message) : std::runtime_error(message) { }
+};
+
+/*
+Columnar file layout (all integers little-endian):
+    Header:     "HGSX", u32 version, u32 column count
+    Blocks:     u32 row count n (0 ends the block list), then one array per column:
+                i64 session_id[n], i32 player_id[n], u16 category_id[n], u16 mode_id[n],
+                i32 score_centi[n], i64 played_at[n] (Unix seconds),
+                u32 player_name_offsets[n + 1] followed by the concatenated player name bytes
+    Dictionary: u32 category count, (u16 id, u16 length, name bytes) per category, then the same for modes
+    Trailer:    u64 total row count
+*/
+class SessionExporter {
+public:
+    // Streams every game session from db into path, returns the number of rows written
+    static std::size_t exportSessions(Database& db, const std::string& path, ExportFormat format, std::size_t chunkSize = 4096);
+
+private:
+    static constexpr std::uint32_t COLUMNAR_VERSION = 1;
+    static constexpr std::uint32_t COLUMN_COUNT = 7;
+
+    // Format writers
+    static void writeCSVHeader(std::ofstream& file);
+    static void writeCSVChunk(std::ofstream& file, const std::vector<SessionRecord>& chunk);
+    static void writeColumnarHeader(std::ofstream& file);
+    static void writeColumnarChunk(std::ofstream& file, const std::vector<SessionRecord>& chunk);
+    static void writeColumnarTrailer(std::ofstream& file, const std::map<int, std::string>& categories, const std::map<int, std::string>& modes, std::uint64_t totalRows);
+
+    // Helpers
+    static std::string escapeCSV(const std::string& value);
+    static void writeLE(std::ofstream& file, std::uint64_t value, int byteCount);
+};
+
+#endif  // SESSION_EXPORTER_H
@@ -0,0 +1,73 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SHARDED_DATABASE_H
+#define SHARDED_DATABASE_H
+
+#include "SharedDatabase.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+
+/*
+Optional layout with one database file per category plus a small shared players file.
+Each category file has the full schema with only its own questions and sessions, so games
+in different categories write to different files and never wait on each other's lock.
+Player IDs are handed out by the players file, which is attached to a category file to copy
+a player in under the same ID, so local joins and foreign keys keep working unchanged.
+Question IDs are only unique within a category, which is how every caller uses them.
+*/
+class ShardedDatabase {
+public:
+    // Creates any missing files in shardFolder and opens every shard
+    explicit ShardedDatabase(const std::string& shardFolder, std::size_t readersPerShard = 1, bool enableQueryProfiling = false);
+
+    // Connections are owned by this object
+    ShardedDatabase(const ShardedDatabase&) = delete;
+    ShardedDatabase& operator=(const ShardedDatabase&) = delete;
+
+    // Players, from the shared players file
+    int addPlayer(const std::string& playerName);
+    double getAverageScore(int playerId);  // Over every category, -1 without history
+
+    // Routed to the category's shard
+    void saveScore(int playerId, Category category, GameMode mode, int scoreCenti);
+    void saveQuestionStats(Category category, const std::vector<QuestionStat>& stats);
+    std::vector<QuestionAnswer> getQuestions(Category category);
+    std::vector<std::string> getHighScores(Category category, GameMode mode, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);
+    std::vector<std::pair<std::string, int>> getTopScores(Category category, GameMode mode, int limit = 10, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);
+    int getPlayerRank(int playerId, Category category, GameMode mode);
+    double getPercentile(int scoreCenti, Category category, GameMode mode);
+
+    // Adds every connection's query profiles and contention counters to target
+    void collectStatistics(Database& target);
+
+    // Getters
+    std::string getShardPath(Category category) const;
+    std::string getPlayersPath() const;
+
+private:
+    const std::vector<Category> CATEGORIES = { Category::CSC_111, Category::CSC_211, Category::CSC_231 };
+
+    std::string shardFolder;
+
+    Database players;
+    std::mutex playersMutex;
+    std::set<int> importedPlayers;  // Players already copied into every shard by this process
+
+    std::map<Category, std::unique_ptr<SharedDatabase>> shards;
+
+    // Helpers
+    SharedDatabase& getShard(Category category);
+};
+
+#endif  // SHARDED_DATABASE_H
@@ -0,0 +1,90 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SHARED_DATABASE_H
+#define SHARED_DATABASE_H
+
+#include "Database.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+/*
+Thread-safe front for one database file. Writes go to a single writer connection, one thread at
+a time. Reads are served by a pool of read-only connections. The file is switched to WAL
+journaling, so readers see the last committed state and are not blocked while a write is in
+progress. A reader is leased to one thread per call, and callers wait when all are in use.
+*/
+class SharedDatabase {
+public:
+    // Constructor opens every connection, the database must already be initialized
+    explicit SharedDatabase(const std::string& dbPath, std::size_t readerCount = DEFAULT_READER_COUNT, bool enableQueryProfiling = false);
+
+    // Connections are owned by this object
+    SharedDatabase(const SharedDatabase&) = delete;
+    SharedDatabase& operator=(const SharedDatabase&) = delete;
+
+    // Writes, serialized on the writer connection
+    int addPlayer(const std::string& playerName);
+    void saveScore(int playerId, Category category, GameMode mode, int scoreCenti);
+    void saveQuestionStats(const std::vector<QuestionStat>& stats);
+    void loadAllQuestionFiles();
+    void loadQuestionsFromTSV(const std::string& filePath, const std::string& category);
+    void importPlayer(const std::string& playersDbPath, int playerId);
+
+    // Reads, run in parallel on the reader pool
+    std::vector<QuestionAnswer> getQuestions(Category category);
+    std::vector<std::string> getHighScores(Category category, GameMode mode, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);
+    std::vector<std::pair<std::string, int>> getTopScores(Category category, GameMode mode, int limit = 10, LeaderboardWindow window = LeaderboardWindow::ALL_TIME);
+    double getAverageScore(int playerId);
+    std::pair<long long, long long> getScoreTotals(int playerId);
+    int getPlayerRank(int playerId, Category category, GameMode mode);
+    double getPercentile(int scoreCenti, Category category, GameMode mode);
+
+    // Adds every connection's query profiles and contention counters to target
+    void collectStatistics(Database& target);
+
+    // Getters
+    std::size_t getReaderCount() const { return readers.size(); }
+
+private:
+    static constexpr std::size_t DEFAULT_READER_COUNT = 4;
+
+    Database writer;
+    std::mutex writerMutex;
+
+    std::vector<std::unique_ptr<Database>> readers;
+    std::vector<Database*> idleReaders;
+    std::mutex readerMutex;
+    std::condition_variable readerReleased;
+
+    // Hands a reader to one caller and returns it to the pool when destroyed
+    class ReaderLease {
+    public:
+        ReaderLease(SharedDatabase& owner, Database& reader) : owner(owner), reader(reader) { }
+        ~ReaderLease() { owner.releaseReader(reader); }
+
+        ReaderLease(const ReaderLease&) = delete;
+        ReaderLease& operator=(const ReaderLease&) = delete;
+
+        Database* operator->() { return &reader; }
+
+    private:
+        SharedDatabase& owner;
+        Database& reader;
+    };
+
+    // Reader pool
+    ReaderLease acquireReader();
+    void releaseReader(Database& reader);
+};
+
+#endif  // SHARED_DATABASE_H
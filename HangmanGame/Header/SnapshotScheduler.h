@@ -0,0 +1,68 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef SNAPSHOT_SCHEDULER_H
+#define SNAPSHOT_SCHEDULER_H
+
+#include "Database.h"
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+/*
+Writes an in-memory database to a file on a timer and once more when stopped. Its connection is
+opened by start and kept until stop, which also keeps the in-memory database alive in between.
+Games never wait on the file: the copy to disk and its fsync run on this thread, and the most
+that can be lost is what was saved since the last snapshot.
+*/
+class SnapshotScheduler {
+public:
+    // Constructor and destructor
+    SnapshotScheduler() = default;
+    ~SnapshotScheduler();
+
+    // The worker thread has a single owner
+    SnapshotScheduler(const SnapshotScheduler&) = delete;
+    SnapshotScheduler& operator=(const SnapshotScheduler&) = delete;
+
+    // Job control
+    void start(const std::string& dbPath, const std::string& snapshotPath, std::chrono::seconds interval);
+    void stop();  // Writes a final snapshot and waits for it
+
+    // Getters
+    bool isRunning() const { return running; }
+    std::size_t getSnapshotCount() const { return snapshotCount; }
+    std::string getError() const;  // Empty unless the last snapshot failed
+
+private:
+    Database source;
+    std::string snapshotPath;
+    std::chrono::seconds interval{ 0 };
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::atomic<std::size_t> snapshotCount{ 0 };
+
+    std::mutex stopMutex;
+    std::condition_variable stopSignal;
+    bool stopRequested = false;
+
+    mutable std::mutex errorMutex;
+    std::string error;
+
+    // Helpers
+    void run();
+    void writeSnapshot();
+};
+
+#endif  // SNAPSHOT_SCHEDULER_H
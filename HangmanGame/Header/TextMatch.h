@@ -0,0 +1,50 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#ifndef TEXT_MATCH_H
+#define TEXT_MATCH_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Case-insensitive text comparison used to check guesses against answers
+class TextMatch {
+public:
+    // Returns a case-folded copy of text (done once per answer when questions are loaded)
+    static std::string foldCase(std::string_view text);
+
+    // Compares a raw guess against an answer already passed through foldCase, without allocating
+    static bool equalsFolded(std::string_view guess, std::string_view foldedAnswer);
+
+    // Decodes the UTF-8 code point at pos, advances pos past it and writes its folded encoding to out (1-4 bytes)
+    static std::size_t foldNext(std::string_view text, std::size_t& pos, char* out);
+
+    // Folds case, turns punctuation into spaces and collapses whitespace runs into out (truncated to capacity)
+    static std::size_t normalize(std::string_view text, char* out, std::size_t capacity);
+    static std::string normalize(std::string_view text);
+
+    // Levenshtein distance between a and b, or maxDistance + 1 once it is known to exceed maxDistance
+    static int boundedEditDistance(std::string_view a, std::string_view b, int maxDistance);
+
+    static constexpr int MAX_EDIT_DISTANCE = 16;  // Upper bound accepted by boundedEditDistance
+
+private:
+    // Comparison kernels
+    static bool equalsFoldedAscii(const char* guess, const char* foldedAnswer, std::size_t length, std::size_t& mismatchOffset);
+    static bool equalsFoldedUnicode(std::string_view guess, std::string_view foldedAnswer);
+    static int myersEditDistance(std::string_view pattern, std::string_view text, int maxDistance);
+    static int bandedEditDistance(std::string_view a, std::string_view b, int maxDistance);
+
+    // UTF-8 helpers
+    static char32_t decodeUtf8(std::string_view text, std::size_t& pos);
+    static char32_t foldCodePoint(char32_t codePoint);
+};
+
+#endif  // TEXT_MATCH_H
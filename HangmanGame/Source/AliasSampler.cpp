@@ -0,0 +1,71 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "AliasSampler.h"
+#include <stdexcept>
+
+AliasSampler::AliasSampler(const std::vector<double>& weights) {
+    const std::size_t count = weights.size();
+    double total = 0.0;
+
+    for (double weight : weights) {
+        if (weight < 0.0) throw std::invalid_argument("Sampling weights cannot be negative");
+        total += weight;
+    }
+
+    if ((count == 0) || (total <= 0.0)) throw std::invalid_argument("Sampling weights must have a positive sum");
+
+    probability.assign(count, 0.0);
+    alias.assign(count, 0);
+
+    // Scale so the average column holds exactly 1, then pair under-full columns with over-full ones
+    std::vector<double> scaled(count);
+    std::vector<std::size_t> small;
+    std::vector<std::size_t> large;
+
+    for (std::size_t i = 0; i < count; i++) {
+        scaled[i] = weights[i] * static_cast<double>(count) / total;
+
+        if (scaled[i] < 1.0) small.push_back(i);
+        else large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        std::size_t under = small.back();
+        std::size_t over = large.back();
+        small.pop_back();
+
+        probability[under] = scaled[under];
+        alias[under] = over;
+
+        scaled[over] = (scaled[over] + scaled[under]) - 1.0;
+
+        if (scaled[over] < 1.0) {
+            large.pop_back();
+            small.push_back(over);
+        }
+    }
+
+    // Anything left is full up to rounding error
+    for (std::size_t i : large) probability[i] = 1.0;
+    for (std::size_t i : small) probability[i] = 1.0;
+}
+
+std::size_t AliasSampler::sample(std::mt19937& gen) const {
+    if (probability.empty()) throw std::logic_error("Cannot sample from an empty alias table");
+
+    std::uniform_int_distribution<std::size_t> column(0, probability.size() - 1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    std::size_t i = column(gen);
+
+    return (coin(gen) < probability[i]) ? i : alias[i];
+}
+
+// ALIAS_SAMPLER_CPP
@@ -0,0 +1,127 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "AnswerMatcher.h"
+#include "TextMatch.h"
+#include <map>
+#include <queue>
+
+AnswerMatcher::AnswerMatcher(const std::vector<std::string>& answers) {
+    std::vector<std::string> foldedAnswers;
+
+    for (const std::string& answer : answers) {
+        if (answer.empty()) continue;
+
+        foldedAnswers.push_back(TextMatch::foldCase(answer));
+        normalizedAnswers.push_back(TextMatch::normalize(answer));
+    }
+
+    // A single answer is compared directly with the SIMD kernel, the trie only pays off with alternates
+    if (foldedAnswers.size() == 1) singleFoldedAnswer = foldedAnswers.front();
+    else if (foldedAnswers.size() > 1) buildTrie(foldedAnswers);
+}
+
+void AnswerMatcher::buildTrie(const std::vector<std::string>& foldedAnswers) {
+    // Build a pointer-free trie with ordered children first
+    struct BuildNode {
+        std::map<unsigned char, std::uint32_t> children;
+        bool isTerminal = false;
+    };
+
+    std::vector<BuildNode> buildNodes(1);
+
+    for (const std::string& answer : foldedAnswers) {
+        std::uint32_t current = 0;
+
+        for (char c : answer) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            auto child = buildNodes[current].children.find(byte);
+
+            if (child == buildNodes[current].children.end()) {
+                buildNodes.emplace_back();
+                std::uint32_t created = static_cast<std::uint32_t>(buildNodes.size() - 1);
+                buildNodes[current].children[byte] = created;
+                current = created;
+            }
+            else {
+                current = child->second;
+            }
+        }
+
+        buildNodes[current].isTerminal = true;
+    }
+
+    // Flatten breadth-first so each node's edges sit next to each other
+    std::vector<std::uint32_t> flatIndex(buildNodes.size(), NO_NODE);
+    std::queue<std::uint32_t> pending;
+
+    nodes.reserve(buildNodes.size());
+    edges.reserve(buildNodes.size() - 1);
+
+    flatIndex[0] = 0;
+    nodes.push_back({ 0, 0, buildNodes[0].isTerminal });
+    pending.push(0);
+
+    while (!pending.empty()) {
+        std::uint32_t buildIndex = pending.front();
+        pending.pop();
+
+        Node& node = nodes[flatIndex[buildIndex]];
+        node.firstEdge = static_cast<std::uint32_t>(edges.size());
+        node.edgeCount = static_cast<std::uint32_t>(buildNodes[buildIndex].children.size());
+
+        for (const auto& [byte, child] : buildNodes[buildIndex].children) {
+            flatIndex[child] = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back({ 0, 0, buildNodes[child].isTerminal });
+            edges.push_back({ byte, flatIndex[child] });
+            pending.push(child);
+        }
+    }
+}
+
+std::uint32_t AnswerMatcher::step(std::uint32_t node, unsigned char byte) const {
+    const Node& current = nodes[node];
+
+    // Fan-out is tiny for natural-language answers, so a linear scan of the sorted edges is enough
+    for (std::uint32_t i = current.firstEdge; i < current.firstEdge + current.edgeCount; i++) {
+        if (edges[i].byte == byte) return edges[i].target;
+        if (edges[i].byte > byte) break;
+    }
+
+    return NO_NODE;
+}
+
+bool AnswerMatcher::matches(std::string_view guess) const {
+    if (nodes.empty()) return !singleFoldedAnswer.empty() && TextMatch::equalsFolded(guess, singleFoldedAnswer);
+
+    // Walk the trie while folding the guess on the fly
+    std::uint32_t current = 0;
+    std::size_t pos = 0;
+
+    while ((pos < guess.size()) && (current != NO_NODE)) {
+        unsigned char byte = static_cast<unsigned char>(guess[pos]);
+
+        if (byte < 0x80) {
+            if ((byte >= 'A') && (byte <= 'Z')) byte |= 0x20;
+
+            current = step(current, byte);
+            pos++;
+        }
+        else {
+            char folded[4];
+            std::size_t length = TextMatch::foldNext(guess, pos, folded);
+
+            for (std::size_t i = 0; (i < length) && (current != NO_NODE); i++) current = step(current, static_cast<unsigned char>(folded[i]));
+        }
+    }
+
+    return (current != NO_NODE) && nodes[current].isTerminal;
+}
+
+// ANSWER_MATCHER_CPP
@@ -0,0 +1,142 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "BackupScheduler.h"
+#include "Database.h"
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+
+BackupScheduler::~BackupScheduler() {
+    stop();
+}
+
+void BackupScheduler::start(const std::string& dbPath, const std::string& backupFolder, std::chrono::minutes interval) {
+    if (worker.joinable()) throw DatabaseException("Backups are already being taken");
+    if (interval.count() < 1) throw DatabaseException("Backup interval must be at least one minute");
+
+    this->dbPath = dbPath;
+    this->backupFolder = backupFolder;
+    this->interval = interval;
+
+    stopRequested = false;
+    running = true;
+    backupCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        lastBackupPath.clear();
+        error.clear();
+    }
+
+    worker = std::thread(&BackupScheduler::run, this);
+}
+
+void BackupScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+
+    stopSignal.notify_all();
+
+    if (worker.joinable()) worker.join();
+}
+
+std::string BackupScheduler::getLastBackupPath() const {
+    std::lock_guard<std::mutex> lock(resultMutex);
+    return lastBackupPath;
+}
+
+std::string BackupScheduler::getError() const {
+    std::lock_guard<std::mutex> lock(resultMutex);
+    return error;
+}
+
+void BackupScheduler::run() {
+    while (!stopRequested) {
+        takeBackup();
+
+        std::unique_lock<std::mutex> lock(stopMutex);
+
+        if (stopSignal.wait_for(lock, interval, [this] { return stopRequested.load(); })) break;
+    }
+
+    running = false;
+}
+
+void BackupScheduler::takeBackup() {
+    const std::string backupPath = backupFolder + "/" + getBackupName();
+    const std::string partialPath = backupPath + ".partial";
+
+    try {
+        std::filesystem::create_directories(backupFolder);
+        std::filesystem::remove(partialPath);
+
+        Database db;
+        db.open(dbPath, true);
+
+        bool isComplete = db.backupTo(partialPath, PAGES_PER_STEP, STEP_PAUSE, [this](int, int) { return !stopRequested; });
+
+        db.close();
+
+        if (!isComplete) {
+            std::filesystem::remove(partialPath);
+            return;
+        }
+
+        std::filesystem::rename(partialPath, backupPath);
+        removeOldBackups();
+
+        backupCount++;
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        lastBackupPath = backupPath;
+        error.clear();
+    }
+    catch (const std::exception& err) {
+        std::error_code ignored;
+        std::filesystem::remove(partialPath, ignored);
+
+        // Kept for the caller, the next backup tries again
+        std::lock_guard<std::mutex> lock(resultMutex);
+        error = err.what();
+    }
+}
+
+void BackupScheduler::removeOldBackups() {
+    const std::string prefix = std::filesystem::path(dbPath).stem().string() + "_";
+    std::vector<std::filesystem::path> backups;
+
+    for (const auto& entry : std::filesystem::directory_iterator(backupFolder)) {
+        const std::string name = entry.path().filename().string();
+
+        if ((name.rfind(prefix, 0) == 0) && (entry.path().extension() == ".db")) backups.push_back(entry.path());
+    }
+
+    if (backups.size() <= BACKUPS_KEPT) return;
+
+    std::sort(backups.begin(), backups.end());
+
+    for (std::size_t i = 0; i < backups.size() - BACKUPS_KEPT; i++) std::filesystem::remove(backups[i]);
+}
+
+std::string BackupScheduler::getBackupName() const {
+    std::time_t now = std::time(nullptr);
+    std::ostringstream name;
+
+    name << std::filesystem::path(dbPath).stem().string() << "_" << std::put_time(std::gmtime(&now), "%Y%m%d_%H%M%S") << ".db";
+
+    return name.str();
+}
+
+// BACKUP_SCHEDULER_CPP
@@ -8,35 +8,101 @@ Honors Project: Hangman
 */
 
 #include "Database.h"
+#include "Profiler.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
-
-Database::Database() : db(nullptr) { }
+#include <algorithm>
+#include <map>
+#include <cctype>
+#include <ctime>
+#include <thread>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const std::string Database::MEMORY_DB_PATH = "file:/Hangman_DB?vfs=memdb";
+
+Database::Database() : db(nullptr), referenceIdsLoaded(false), playerBestDataVersion(-1), backoffRandom(std::random_device{}()), queryProfilingEnabled(false) {
+    categoryIds.fill(-1);
+    modeIds.fill(-1);
+    playerBestTreesLoaded.fill(false);
+}
 
 void Database::initialize(const std::string& dbPath) {
+    PROFILE_SCOPE("Database::initialize");
+
     try {
         if (!databaseExists(dbPath)) {
             open(dbPath);
+
+            // Must be set before the first table is created, lets compaction return freed pages in small steps
+            executeQuery("PRAGMA auto_vacuum = INCREMENTAL;");
             createTables();
+            loadAllQuestionFiles();
+            close();
+        }
+        else {
+            open(dbPath);
+            upgradeSchema();
+            close();
+        }
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to initialize database: " + std::string(err.what()));
+    }
+}
 
-            std::string category = "";
-            std::string filePath = "";
+void Database::initializeShard(const std::string& dbPath, Category category) {
+    PROFILE_SCOPE("Database::initializeShard");
 
-            for (const std::string& file : CATEGORY_FILES) {
-                category = file.substr(0, file.find('.'));
-                filePath = RESOURCES_FOLDER + "/" + file;
+    try {
+        if (!databaseExists(dbPath)) {
+            const std::string categoryName = Hangman::categoryToString(category);
 
-                this->loadQuestionsFromTSV(filePath, category);
-            }
+            open(dbPath);
 
+            executeQuery("PRAGMA auto_vacuum = INCREMENTAL;");
+            createTables();
+            loadQuestionsFromTSV(RESOURCES_FOLDER + "/" + categoryName + ".tsv", categoryName);
+            close();
+        }
+        else {
+            open(dbPath);
+            upgradeSchema();
             close();
         }
     }
     catch (const std::exception& err) {
-        throw DatabaseException("Failed to initialize database: " + std::string(err.what()));
+        throw DatabaseException("Failed to initialize database shard: " + std::string(err.what()));
+    }
+}
+
+void Database::initializeInMemory(const std::string& snapshotPath) {
+    PROFILE_SCOPE("Database::initializeInMemory");
+
+    try {
+        open(MEMORY_DB_PATH);
+
+        if (databaseExists(snapshotPath)) {
+            loadSnapshot(snapshotPath);
+            upgradeSchema();
+        }
+        else {
+            executeQuery("PRAGMA auto_vacuum = INCREMENTAL;");
+            createTables();
+            loadAllQuestionFiles();
+        }
+    }
+    catch (const std::exception& err) {
+        close();
+        throw DatabaseException("Failed to initialize in-memory database: " + std::string(err.what()));
     }
 }
 
@@ -44,15 +110,39 @@ bool Database::databaseExists(const std::string& dbPath) const {
     return std::filesystem::exists(dbPath);
 }
 
-void Database::open(const std::string& dbPath) {
+void Database::open(const std::string& dbPath, bool readOnly) {
     if (isOpen()) {
         close();
     }
 
-    int result = sqlite3_open(dbPath.c_str(), &db);
-    checkError(result, "Opening database");
+    int result = sqlite3_open_v2(dbPath.c_str(), &db, (readOnly ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) | SQLITE_OPEN_URI, nullptr);
+
+    if (result != SQLITE_OK) {
+        // A handle is returned even on failure and has to be released
+        std::string error = getLastError();
+
+        sqlite3_close(db);
+        db = nullptr;
+
+        throw DatabaseException("Opening database failed: " + error);
+    }
+
+    // Cached reference and player IDs only stay valid for the same database file
+    if (dbPath != currentDbPath) {
+        referenceIdsLoaded = false;
+        clearPlayerCache();
+    }
+
     currentDbPath = dbPath;
 
+    // Other processes may have saved scores since the trees were loaded
+    playerBestTreesLoaded.fill(false);
+
+    if (queryProfilingEnabled) registerTrace();
+
+    // Other game processes and the compaction job write to the same file, wait out their locks instead of failing
+    sqlite3_busy_handler(db, busyCallback, this);
+
     executeQuery("PRAGMA foreign_keys = ON;");
 }
 
@@ -67,6 +157,174 @@ bool Database::isOpen() const {
     return db != nullptr;
 }
 
+void Database::enableWriteAheadLog() {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    // Nothing reaches a disk, and its locks are only held for the length of a memory copy
+    if (isInMemory()) return;
+
+    auto stmt = prepareStatement("PRAGMA journal_mode = WAL;");
+
+    // SQLite answers with the mode now in effect, which stays the old one if the switch failed
+    if ((sqlite3_step(stmt.get()) != SQLITE_ROW) || (std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0))) != "wal")) {
+        throw DatabaseException("Failed to switch the database to WAL journaling");
+    }
+}
+
+bool Database::isInMemory() const {
+    return isOpen() && (currentDbPath == MEMORY_DB_PATH);
+}
+
+void Database::saveSnapshot(const std::string& filePath) {
+    PROFILE_SCOPE("Database::saveSnapshot");
+
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    const std::string tempPath = filePath + ".tmp";
+    std::unique_ptr<unsigned char, decltype(&sqlite3_free)> image(nullptr, sqlite3_free);
+    sqlite3_int64 imageSize = 0;
+    std::FILE* file = nullptr;
+    bool isTransactionActive = false;
+
+    try {
+        // The read lock only covers copying the image in memory, writing and syncing the file happen without it
+        executeQuery("BEGIN TRANSACTION;");
+        isTransactionActive = true;
+
+        executeQuery("SELECT count(*) FROM sqlite_schema;");  // BEGIN alone takes no lock, the first read does
+        image.reset(sqlite3_serialize(db, "main", &imageSize, 0));
+
+        executeQuery("COMMIT TRANSACTION;");
+        isTransactionActive = false;
+
+        if (image == nullptr) throw DatabaseException("Serializing the database failed: " + getLastError());
+
+        file = std::fopen(tempPath.c_str(), "wb");
+
+        if (file == nullptr) throw DatabaseException("Could not create " + tempPath);
+
+        bool isWritten = (std::fwrite(image.get(), 1, static_cast<std::size_t>(imageSize), file) == static_cast<std::size_t>(imageSize)) && (std::fflush(file) == 0);
+
+#ifdef _WIN32
+        isWritten = isWritten && (_commit(_fileno(file)) == 0);
+#else
+        isWritten = isWritten && (fsync(fileno(file)) == 0);
+#endif
+
+        std::fclose(file);
+        file = nullptr;
+
+        if (!isWritten) throw DatabaseException("Could not write " + tempPath);
+
+        // Readers of the file see the old snapshot or the new one, never a partial copy
+        std::filesystem::rename(tempPath, filePath);
+    }
+    catch (const std::exception& err) {
+        if (isTransactionActive) rollbackTransaction();
+        if (file != nullptr) std::fclose(file);
+
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+
+        throw DatabaseException("Failed to save snapshot: " + std::string(err.what()));
+    }
+}
+
+bool Database::backupTo(const std::string& filePath, int pagesPerStep, std::chrono::milliseconds pause, const std::function<bool(int, int)>& onStep) {
+    PROFILE_SCOPE("Database::backupTo");
+
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    sqlite3* file = nullptr;
+    sqlite3_backup* backup = nullptr;
+    bool isComplete = false;
+
+    try {
+        file = openSnapshotFile(filePath, true);
+        backup = sqlite3_backup_init(file, "main", db, "main");
+
+        if (backup == nullptr) throw DatabaseException(sqlite3_errmsg(file));
+
+        int stepPages = pagesPerStep;
+        int lastRemaining = -1;
+
+        while (true) {
+            int result = sqlite3_backup_step(backup, stepPages);
+
+            if (result == SQLITE_DONE) {
+                isComplete = true;
+                break;
+            }
+
+            // A busy or locked step copied nothing and is simply tried again after the pause
+            if ((result != SQLITE_OK) && (result != SQLITE_BUSY) && (result != SQLITE_LOCKED)) throw DatabaseException(sqlite3_errstr(result));
+
+            int remaining = sqlite3_backup_remaining(backup);
+
+            // A commit on another connection restarts the copy, larger steps let it finish between commits
+            if ((result == SQLITE_OK) && (lastRemaining >= 0) && (remaining > lastRemaining) && (stepPages > 0)) stepPages *= 2;
+
+            if (result == SQLITE_OK) lastRemaining = remaining;
+
+            if (onStep && !onStep(remaining, sqlite3_backup_pagecount(backup))) break;
+
+            std::this_thread::sleep_for(pause);
+        }
+
+        int result = sqlite3_backup_finish(backup);
+        backup = nullptr;
+
+        if (isComplete && (result != SQLITE_OK)) throw DatabaseException(sqlite3_errmsg(file));
+
+        sqlite3_close(file);
+    }
+    catch (const std::exception& err) {
+        if (backup != nullptr) sqlite3_backup_finish(backup);
+
+        sqlite3_close(file);
+        throw DatabaseException("Failed to back up database: " + std::string(err.what()));
+    }
+
+    return isComplete;
+}
+
+void Database::loadSnapshot(const std::string& filePath) {
+    PROFILE_SCOPE("Database::loadSnapshot");
+
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    sqlite3* file = nullptr;
+
+    try {
+        file = openSnapshotFile(filePath, false);
+
+        /*
+        VACUUM INTO rather than a backup, the backup API copies the file's header as is, and a file
+        left in WAL mode by the disk-backed game could then not be opened in memory
+        */
+        sqlite3_stmt* rawStmt = nullptr;
+
+        if (sqlite3_prepare_v2(file, "VACUUM INTO ?;", -1, &rawStmt, nullptr) != SQLITE_OK) throw DatabaseException(sqlite3_errmsg(file));
+
+        StmtPtr stmt(rawStmt, sqlite3_finalize);
+        bindText(stmt.get(), 1, currentDbPath);
+
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) throw DatabaseException(sqlite3_errmsg(file));
+
+        stmt.reset();
+        sqlite3_close(file);
+    }
+    catch (const std::exception& err) {
+        sqlite3_close(file);
+        throw DatabaseException("Failed to load snapshot: " + std::string(err.what()));
+    }
+
+    // Everything cached came from the contents that were just replaced
+    referenceIdsLoaded = false;
+    clearPlayerCache();
+    playerBestTreesLoaded.fill(false);
+}
+
 void Database::createTables() {
     bool isTransactionActive = false;
     
@@ -110,6 +368,26 @@ void Database::createTables() {
                 UNIQUE(category_id, question_text)
             );)",
 
+            // Question_Answers table - alternate accepted answers for a question
+            R"(CREATE TABLE IF NOT EXISTS Question_Answers (
+                question_answer_id INTEGER PRIMARY KEY AUTOINCREMENT,
+                question_id INTEGER NOT NULL,
+                answer_text TEXT NOT NULL,
+                FOREIGN KEY(question_id) REFERENCES Questions(question_id) ON DELETE CASCADE,
+                UNIQUE(question_id, answer_text)
+            );)",
+
+            // Question_Stats table - running play counters per question, for tuning question banks
+            R"(CREATE TABLE IF NOT EXISTS Question_Stats (
+                question_id INTEGER PRIMARY KEY,
+                times_asked INTEGER NOT NULL DEFAULT 0,
+                times_correct INTEGER NOT NULL DEFAULT 0,
+                total_guesses INTEGER NOT NULL DEFAULT 0,
+                total_answer_ms INTEGER NOT NULL DEFAULT 0,
+                updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+                FOREIGN KEY(question_id) REFERENCES Questions(question_id) ON DELETE CASCADE
+            );)",
+
             // Game_Sessions table - tracks individual game sessions
             R"(CREATE TABLE IF NOT EXISTS Game_Sessions (
                 session_id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -118,6 +396,7 @@ void Database::createTables() {
                 mode_id INTEGER NOT NULL,
                 score REAL NOT NULL CHECK((score >= 0.00) AND (score <= 100.00)),
                 played_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+                score_centi INTEGER NOT NULL DEFAULT 0 CHECK(score_centi BETWEEN 0 AND 10000),
                 FOREIGN KEY(player_id) REFERENCES Players(player_id) ON DELETE CASCADE,
                 FOREIGN KEY(category_id) REFERENCES Categories(category_id) ON DELETE CASCADE,
                 FOREIGN KEY(mode_id) REFERENCES Game_Modes(mode_id) ON DELETE CASCADE
@@ -132,11 +411,82 @@ void Database::createTables() {
                 UNIQUE(session_id)
             );)",
 
+            // Leaderboard table - denormalized copy of each category-mode top 10, ordered for direct display
+            R"(CREATE TABLE IF NOT EXISTS Leaderboard (
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                rank INTEGER NOT NULL CHECK(rank BETWEEN 1 AND 10),
+                session_id INTEGER NOT NULL,
+                player_name TEXT NOT NULL,
+                score_centi INTEGER NOT NULL,
+                played_at TIMESTAMP NOT NULL,
+                tie_count INTEGER NOT NULL DEFAULT 1,
+                PRIMARY KEY(category_id, mode_id, rank),
+                FOREIGN KEY(session_id) REFERENCES Game_Sessions(session_id) ON DELETE CASCADE
+            ) WITHOUT ROWID;)",
+
+            // Score_Histogram table - number of sessions per exact score, per category-mode, for rank lookups
+            R"(CREATE TABLE IF NOT EXISTS Score_Histogram (
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                score_centi INTEGER NOT NULL,
+                session_count INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY(category_id, mode_id, score_centi)
+            ) WITHOUT ROWID;)",
+
+            // Player_Best table - each player's best score per category-mode
+            R"(CREATE TABLE IF NOT EXISTS Player_Best (
+                player_id INTEGER NOT NULL,
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                best_centi INTEGER NOT NULL,
+                PRIMARY KEY(player_id, category_id, mode_id),
+                FOREIGN KEY(player_id) REFERENCES Players(player_id) ON DELETE CASCADE
+            ) WITHOUT ROWID;)",
+
+            // Player_Best_Histogram table - number of players per best score, per category-mode
+            R"(CREATE TABLE IF NOT EXISTS Player_Best_Histogram (
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                score_centi INTEGER NOT NULL,
+                player_count INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY(category_id, mode_id, score_centi)
+            ) WITHOUT ROWID;)",
+
+            // Windowed_Scores table - top 10 sessions of each daily and weekly bucket per category-mode
+            R"(CREATE TABLE IF NOT EXISTS Windowed_Scores (
+                window_type INTEGER NOT NULL,
+                bucket_start INTEGER NOT NULL,
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                session_id INTEGER NOT NULL,
+                player_id INTEGER NOT NULL,
+                score_centi INTEGER NOT NULL,
+                played_at INTEGER NOT NULL,
+                PRIMARY KEY(window_type, bucket_start, category_id, mode_id, session_id),
+                FOREIGN KEY(session_id) REFERENCES Game_Sessions(session_id) ON DELETE CASCADE
+            ) WITHOUT ROWID;)",
+
+            // Session_Rollups table - per player, day, category and mode aggregates of compacted Game_Sessions rows
+            R"(CREATE TABLE IF NOT EXISTS Session_Rollups (
+                player_id INTEGER NOT NULL,
+                category_id INTEGER NOT NULL,
+                mode_id INTEGER NOT NULL,
+                play_date TEXT NOT NULL,
+                session_count INTEGER NOT NULL,
+                total_centi INTEGER NOT NULL,
+                best_centi INTEGER NOT NULL,
+                worst_centi INTEGER NOT NULL,
+                PRIMARY KEY(player_id, category_id, mode_id, play_date),
+                FOREIGN KEY(player_id) REFERENCES Players(player_id) ON DELETE CASCADE
+            ) WITHOUT ROWID;)",
+
             // Indices for performance optimization
             "CREATE INDEX IF NOT EXISTS idx_game_sessions_category_mode_score ON Game_Sessions(category_id, mode_id, score DESC, played_at DESC);",
             "CREATE INDEX IF NOT EXISTS idx_game_sessions_player ON Game_Sessions(player_id);",
             "CREATE INDEX IF NOT EXISTS idx_game_sessions_player_score ON Game_Sessions(player_id, category_id, mode_id, score);",
             "CREATE INDEX IF NOT EXISTS idx_high_scores_session ON High_Scores(session_id);",
+            "CREATE INDEX IF NOT EXISTS idx_windowed_scores_session ON Windowed_Scores(session_id);",
             "CREATE INDEX IF NOT EXISTS idx_questions_category ON Questions(category_id);"
         };
 
@@ -153,6 +503,136 @@ void Database::createTables() {
     }
 }
 
+void Database::upgradeSchema() {
+    bool hasLeaderboard = tableExists("Leaderboard") && columnExists("Leaderboard", "score_centi");
+    bool hasQuestionAnswers = tableExists("Question_Answers");
+    bool hasScoreHistogram = tableExists("Score_Histogram");
+    bool hasPlayerBest = tableExists("Player_Best");
+    bool hasWindowedScores = tableExists("Windowed_Scores");
+
+    // Integer scores are backfilled from the REAL column, which older databases only have
+    if (!columnExists("Game_Sessions", "score_centi")) {
+        bool isTransactionActive = false;
+
+        try {
+            beginTransaction();
+            isTransactionActive = true;
+
+            executeQuery("ALTER TABLE Game_Sessions ADD COLUMN score_centi INTEGER NOT NULL DEFAULT 0 CHECK(score_centi BETWEEN 0 AND 10000);");
+            executeQuery("UPDATE Game_Sessions SET score_centi = CAST(ROUND(score * 100) AS INTEGER);");
+
+            commitTransaction();
+            isTransactionActive = false;
+        }
+        catch (const std::exception& err) {
+            if (isTransactionActive) rollbackTransaction();
+            throw DatabaseException("Failed to upgrade schema: " + std::string(err.what()));
+        }
+    }
+
+    // Leaderboard rows are all derived, one still holding REAL scores is recreated and refilled below
+    if (!hasLeaderboard) executeQuery("DROP TABLE IF EXISTS Leaderboard;");
+
+    // All CREATE statements are idempotent, so this only adds what older databases are missing
+    createTables();
+
+    if (!hasScoreHistogram) {
+        executeQuery(
+            "INSERT INTO Score_Histogram (category_id, mode_id, score_centi, session_count) "
+            "SELECT category_id, mode_id, score_centi, COUNT(*) FROM Game_Sessions GROUP BY category_id, mode_id, score_centi;");
+    }
+
+    if (!hasPlayerBest) {
+        executeQuery(
+            "INSERT INTO Player_Best (player_id, category_id, mode_id, best_centi) "
+            "SELECT player_id, category_id, mode_id, MAX(score_centi) FROM Game_Sessions GROUP BY player_id, category_id, mode_id;");
+        executeQuery(
+            "INSERT INTO Player_Best_Histogram (category_id, mode_id, score_centi, player_count) "
+            "SELECT category_id, mode_id, best_centi, COUNT(*) FROM Player_Best GROUP BY category_id, mode_id, best_centi;");
+    }
+
+    // Only sessions young enough to sit in a kept bucket matter to the windowed leaderboards
+    if (!hasWindowedScores) {
+        bool isTransactionActive = false;
+
+        try {
+            beginTransaction();
+            isTransactionActive = true;
+
+            const std::string recentQuery =
+                "SELECT session_id, category_id, mode_id FROM Game_Sessions "
+                "WHERE played_at >= datetime('now', ?) "
+                "ORDER BY session_id;";
+            auto recentStmt = prepareStatement(recentQuery);
+
+            bindText(recentStmt.get(), 1, "-" + std::to_string(WEEKLY_BUCKETS_KEPT * 7) + " days");
+
+            while (sqlite3_step(recentStmt.get()) == SQLITE_ROW) {
+                updateWindowedScores(sqlite3_column_int(recentStmt.get(), 0), sqlite3_column_int(recentStmt.get(), 1), sqlite3_column_int(recentStmt.get(), 2));
+            }
+
+            commitTransaction();
+            isTransactionActive = false;
+        }
+        catch (const std::exception& err) {
+            if (isTransactionActive) rollbackTransaction();
+            throw DatabaseException("Failed to upgrade schema: " + std::string(err.what()));
+        }
+    }
+
+    // Rebuilding the file is the only way to switch an existing database to incremental vacuuming, done once
+    if (getPragmaInt("auto_vacuum") != 2) {
+        try {
+            executeQuery("PRAGMA auto_vacuum = INCREMENTAL;");
+            executeQuery("VACUUM;");
+        }
+        catch (const DatabaseBusyException&) {
+            // Another process is reading the file, the rebuild is tried again on a later start
+        }
+        catch (const std::exception& err) {
+            throw DatabaseException("Failed to upgrade schema: " + std::string(err.what()));
+        }
+    }
+
+    // Re-import the question banks to pick up alternate answers, existing questions are left untouched
+    if (!hasQuestionAnswers) loadAllQuestionFiles();
+
+    if (!hasLeaderboard) {
+        bool isTransactionActive = false;
+
+        try {
+            beginTransaction();
+            isTransactionActive = true;
+
+            const std::string partitionQuery = "SELECT c.category_id, m.mode_id FROM Categories c, Game_Modes m;";
+            auto partitionStmt = prepareStatement(partitionQuery);
+
+            while (sqlite3_step(partitionStmt.get()) == SQLITE_ROW) {
+                refreshLeaderboard(sqlite3_column_int(partitionStmt.get(), 0), sqlite3_column_int(partitionStmt.get(), 1));
+            }
+
+            commitTransaction();
+            isTransactionActive = false;
+        }
+        catch (const std::exception& err) {
+            if (isTransactionActive) rollbackTransaction();
+            throw DatabaseException("Failed to upgrade schema: " + std::string(err.what()));
+        }
+    }
+}
+
+void Database::loadAllQuestionFiles() {
+    std::string category = "";
+    std::string filePath = "";
+
+    for (const std::string& file : CATEGORY_FILES) {
+        category = file.substr(0, file.find('.'));
+        filePath = RESOURCES_FOLDER + "/" + file;
+
+        this->loadQuestionsFromTSV(filePath, category);
+    }
+}
+
 void Database::loadQuestionsFromTSV(const std::string& filePath, const std::string& categoryName) {
     if (!isOpen()) throw DatabaseException("Database is not open");
 
@@ -173,18 +653,42 @@ void Database::loadQuestionsFromTSV(const std::string& filePath, const std::stri
 
         int categoryId = sqlite3_column_int(categoryStmt.get(), 0);
 
-        // Prepare the insert statement
-        const std::string insertQuery = "INSERT OR IGNORE INTO Questions (category_id, question_text, answer_text) VALUES (?, ?, ?);";
+        // Prepare the insert statements, an existing question keeps its ID and takes the file's answers.
+        // Questions missing from the file are left alone, the file may be cut short or only a partial edit.
+        const std::string insertQuery =
+            "INSERT INTO Questions (category_id, question_text, answer_text) VALUES (?, ?, ?) "
+            "ON CONFLICT(category_id, question_text) DO UPDATE SET answer_text = excluded.answer_text;";
         auto insertStmt = prepareStatement(insertQuery);
 
+        const std::string idQuery = "SELECT question_id FROM Questions WHERE category_id = ? AND question_text = ?;";
+        auto idStmt = prepareStatement(idQuery);
+
+        const std::string clearAlternatesQuery = "DELETE FROM Question_Answers WHERE question_id = ?;";
+        auto clearAlternatesStmt = prepareStatement(clearAlternatesQuery);
+
+        const std::string alternateQuery = "INSERT OR IGNORE INTO Question_Answers (question_id, answer_text) VALUES (?, ?);";
+        auto alternateStmt = prepareStatement(alternateQuery);
+
+        // Each line is: question, answer, then any number of alternate answers, separated by tabs
         std::string line;
         while (std::getline(file, line)) {
-            size_t tabPos = line.find('\t');
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+
+            std::vector<std::string> fields;
+            size_t start = 0;
+            size_t tabPos = 0;
 
-            if (tabPos == std::string::npos) continue;  // Skip malformed lines
+            while ((tabPos = line.find('\t', start)) != std::string::npos) {
+                fields.push_back(line.substr(start, tabPos - start));
+                start = tabPos + 1;
+            }
+
+            fields.push_back(line.substr(start));
 
-            std::string question = line.substr(0, tabPos);
-            std::string answer = line.substr(tabPos + 1);
+            if (fields.size() < 2) continue;  // Skip malformed lines
+
+            const std::string& question = fields[0];
+            const std::string& answer = fields[1];
 
             bindInt(insertStmt.get(), 1, categoryId);
             bindText(insertStmt.get(), 2, question);
@@ -195,8 +699,38 @@ void Database::loadQuestionsFromTSV(const std::string& filePath, const std::stri
             if (result != SQLITE_DONE) throw DatabaseException("Failed to insert question: " + getLastError());
 
             sqlite3_reset(insertStmt.get());
+
+            // Alternate answers need the question's ID, which may predate this import
+            bindInt(idStmt.get(), 1, categoryId);
+            bindText(idStmt.get(), 2, question);
+
+            if (sqlite3_step(idStmt.get()) != SQLITE_ROW) throw DatabaseException("Failed to find question: " + question);
+
+            int questionId = sqlite3_column_int(idStmt.get(), 0);
+            sqlite3_reset(idStmt.get());
+
+            // The file's alternates replace any from an earlier import
+            bindInt(clearAlternatesStmt.get(), 1, questionId);
+
+            if (sqlite3_step(clearAlternatesStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to clear alternate answers: " + getLastError());
+
+            sqlite3_reset(clearAlternatesStmt.get());
+
+            for (size_t i = 2; i < fields.size(); i++) {
+                if (fields[i].empty()) continue;
+
+                bindInt(alternateStmt.get(), 1, questionId);
+                bindText(alternateStmt.get(), 2, fields[i]);
+
+                if (sqlite3_step(alternateStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to insert alternate answer: " + getLastError());
+
+                sqlite3_reset(alternateStmt.get());
+            }
         }
 
+        // A read error part way through rolls the whole import back rather than leaving half a file applied
+        if (file.bad()) throw DatabaseException("Failed to read TSV file: " + filePath);
+
         commitTransaction();
     }
     catch (const std::exception& err) {
@@ -208,74 +742,180 @@ void Database::loadQuestionsFromTSV(const std::string& filePath, const std::stri
 }
 
 std::vector<QuestionAnswer> Database::getQuestions(Category category) {
-    std::string categoryName = Hangman::categoryToString(category);
+    PROFILE_SCOPE("Database::getQuestions");
 
     const std::string query =
-        "SELECT q.question_text, q.answer_text "
+        "SELECT q.question_id, q.question_text, q.answer_text, "
+        "    (SELECT group_concat(qa.answer_text, char(9)) FROM Question_Answers qa WHERE qa.question_id = q.question_id), "
+        "    COALESCE(s.times_asked, 0), COALESCE(s.times_correct, 0) "
         "FROM Questions q "
-        "JOIN Categories c ON q.category_id = c.category_id "
-        "WHERE c.category_name = ? "
+        "LEFT JOIN Question_Stats s ON q.question_id = s.question_id "
+        "WHERE q.category_id = ? "
         "ORDER BY RANDOM();";
 
     auto stmt = prepareStatement(query);
-    bindText(stmt.get(), 1, categoryName);
+    bindInt(stmt.get(), 1, getCategoryId(category));
 
     std::vector<QuestionAnswer> questions;
     while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        std::string question = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
-        std::string answer = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+        int questionId = sqlite3_column_int(stmt.get(), 0);
+        std::string question = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+        std::string answer = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+        std::vector<std::string> alternates;
+
+        // Alternates come back tab-separated, or NULL when there are none
+        const unsigned char* alternateText = sqlite3_column_text(stmt.get(), 3);
+
+        if (alternateText != nullptr) {
+            std::istringstream alternateStream(reinterpret_cast<const char*>(alternateText));
+            std::string alternate;
+
+            while (std::getline(alternateStream, alternate, '\t')) alternates.push_back(alternate);
+        }
+
+        questions.emplace_back(question, answer, alternates, questionId);
 
-        questions.emplace_back(question, answer);
+        // Smoothed miss rate, so unseen questions start at 0.5 and move as results come in
+        int timesAsked = sqlite3_column_int(stmt.get(), 4);
+        int timesCorrect = sqlite3_column_int(stmt.get(), 5);
+
+        questions.back().difficulty = 1.0 - ((timesCorrect + 1.0) / (timesAsked + 2.0));
     }
 
     return questions;
 }
 
-int Database::addPlayer(const std::string& playerName) {
+long long Database::getTimesAsked(Category category) {
     if (!isOpen()) throw DatabaseException("Database connection is not open");
 
-    int playerId = -1;
+    const std::string query =
+        "SELECT COALESCE(SUM(s.times_asked), 0) "
+        "FROM Question_Stats s "
+        "JOIN Questions q ON s.question_id = q.question_id "
+        "WHERE q.category_id = ?;";
 
-    try {
-        beginTransaction();
+    auto stmt = prepareStatement(query);
+    bindInt(stmt.get(), 1, getCategoryId(category));
 
-        // Check if player exists
-        const std::string checkQuery = "SELECT player_id FROM Players WHERE player_name = ?;";
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) throw DatabaseException("Query for questions asked failed");
 
-        auto checkStmt = prepareStatement(checkQuery);
-        bindText(checkStmt.get(), 1, playerName);
+    return sqlite3_column_int64(stmt.get(), 0);
+}
 
-        if (sqlite3_step(checkStmt.get()) == SQLITE_ROW) {
-            playerId = sqlite3_column_int(checkStmt.get(), 0);
-        }
-        else {
-            // Player doesn't exist, insert new player
-            const std::string insertQuery = "INSERT INTO Players (player_name) VALUES (?);";
+void Database::saveQuestionStats(const std::vector<QuestionStat>& stats) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+    if (stats.empty()) return;
 
-            auto insertStmt = prepareStatement(insertQuery);
-            bindText(insertStmt.get(), 1, playerName);
+    retryOnBusy([&] { saveQuestionStatsTransaction(stats); });
+}
 
-            if (sqlite3_step(insertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to insert player: " + getLastError());
+void Database::saveQuestionStatsTransaction(const std::vector<QuestionStat>& stats) {
+    bool isTransactionActive = false;
+
+    try {
+        beginTransaction();
+        isTransactionActive = true;
 
-            playerId = static_cast<int>(sqlite3_last_insert_rowid(db));
+        // One prepared upsert reused for the whole batch
+        const std::string upsertQuery =
+            "INSERT INTO Question_Stats (question_id, times_asked, times_correct, total_guesses, total_answer_ms) "
+            "VALUES (?, ?, ?, ?, ?) "
+            "ON CONFLICT(question_id) DO UPDATE SET "
+            "    times_asked = times_asked + excluded.times_asked, "
+            "    times_correct = times_correct + excluded.times_correct, "
+            "    total_guesses = total_guesses + excluded.total_guesses, "
+            "    total_answer_ms = total_answer_ms + excluded.total_answer_ms, "
+            "    updated_at = CURRENT_TIMESTAMP;";
+
+        auto upsertStmt = prepareStatement(upsertQuery);
+
+        for (const QuestionStat& stat : stats) {
+            bindInt(upsertStmt.get(), 1, stat.questionId);
+            bindInt(upsertStmt.get(), 2, stat.timesAsked);
+            bindInt(upsertStmt.get(), 3, stat.timesCorrect);
+            bindInt(upsertStmt.get(), 4, stat.totalGuesses);
+            bindInt64(upsertStmt.get(), 5, stat.totalAnswerMs);
+
+            if (sqlite3_step(upsertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to upsert question stats: " + getLastError());
+
+            sqlite3_reset(upsertStmt.get());
         }
 
         commitTransaction();
+        isTransactionActive = false;
+    }
+    catch (const DatabaseBusyException&) {
+        if (isTransactionActive) rollbackTransaction();
+        throw;  // Left for retryOnBusy
     }
     catch (const std::exception& err) {
-        rollbackTransaction();
-        throw DatabaseException("Failed to add player: " + std::string(err.what()));
+        if (isTransactionActive) rollbackTransaction();
+        throw DatabaseException("Failed to save question stats: " + std::string(err.what()));
     }
+}
 
-    if (playerId == -1) throw DatabaseException("Failed to get player ID after insertion");
+int Database::addPlayer(const std::string& playerName) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
 
-    return playerId;
-}
+    // Repeat players resolve without touching SQLite
+    int playerId = findCachedPlayerId(playerName);
 
-bool Database::playerExists(const std::string& playerName) {
-    const std::string query = "SELECT 1 FROM Players WHERE player_name = ?;";
+    if (playerId != -1) return playerId;
 
-    auto stmt = prepareStatement(query);
+    try {
+        // New players are inserted and return their ID in a single statement
+        const std::string upsertQuery =
+            "INSERT INTO Players (player_name) VALUES (?) "
+            "ON CONFLICT(player_name) DO NOTHING "
+            "RETURNING player_id;";
+
+        auto upsertStmt = prepareStatement(upsertQuery);
+        bindText(upsertStmt.get(), 1, playerName);
+
+        int result = SQLITE_OK;
+
+        retryOnBusy([&] {
+            result = sqlite3_step(upsertStmt.get());
+
+            if (result == SQLITE_BUSY) {
+                sqlite3_reset(upsertStmt.get());
+                throw DatabaseBusyException("Failed to insert player: " + getLastError());
+            }
+        });
+
+        if (result == SQLITE_ROW) {
+            playerId = sqlite3_column_int(upsertStmt.get(), 0);
+        }
+        else if (result == SQLITE_DONE) {
+            // Conflict: the player already exists but was not cached yet
+            const std::string checkQuery = "SELECT player_id FROM Players WHERE player_name = ?;";
+
+            auto checkStmt = prepareStatement(checkQuery);
+            bindText(checkStmt.get(), 1, playerName);
+
+            if (sqlite3_step(checkStmt.get()) == SQLITE_ROW) playerId = sqlite3_column_int(checkStmt.get(), 0);
+        }
+        else {
+            throw DatabaseException("Failed to insert player: " + getLastError());
+        }
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to add player: " + std::string(err.what()));
+    }
+
+    if (playerId == -1) throw DatabaseException("Failed to get player ID after insertion");
+
+    cachePlayerId(playerName, playerId);
+
+    return playerId;
+}
+
+bool Database::playerExists(const std::string& playerName) {
+    if (findCachedPlayerId(playerName) != -1) return true;
+
+    const std::string query = "SELECT 1 FROM Players WHERE player_name = ?;";
+
+    auto stmt = prepareStatement(query);
     bindText(stmt.get(), 1, playerName);
 
     return sqlite3_step(stmt.get()) == SQLITE_ROW;
@@ -284,250 +924,811 @@ bool Database::playerExists(const std::string& playerName) {
 int Database::getPlayerId(const std::string& playerName) {
     if (!isOpen()) throw DatabaseException("Database connection is not open");
 
+    int playerId = findCachedPlayerId(playerName);
+
+    if (playerId != -1) return playerId;
+
     const std::string query = "SELECT player_id FROM Players WHERE player_name = ?;";
 
     auto stmt = prepareStatement(query);
     bindText(stmt.get(), 1, playerName);
 
-    if (sqlite3_step(stmt.get()) == SQLITE_ROW) return sqlite3_column_int(stmt.get(), 0);
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        playerId = sqlite3_column_int(stmt.get(), 0);
+        cachePlayerId(playerName, playerId);
+
+        return playerId;
+    }
 
     throw DatabaseException("Player not found: " + playerName);
 }
 
-void Database::saveScore(int playerId, const std::string& categoryName, const std::string& modeName, double score) {
+double Database::getAverageScore(int playerId) {
+    auto [totalCenti, sessionCount] = getScoreTotals(playerId);
+
+    if (sessionCount == 0) return -1.0;
+
+    return (static_cast<double>(totalCenti) / 100.0) / static_cast<double>(sessionCount);
+}
+
+std::pair<long long, long long> Database::getScoreTotals(int playerId) {
     if (!isOpen()) throw DatabaseException("Database connection is not open");
 
-    bool isTransactionActive = false;
+    // Live sessions from the idx_game_sessions_player_score index plus compacted ones from Session_Rollups
+    const std::string query =
+        "SELECT COALESCE(SUM(total_centi), 0), COALESCE(SUM(session_count), 0) "
+        "FROM ("
+        "    SELECT SUM(score_centi) AS total_centi, COUNT(*) AS session_count FROM Game_Sessions WHERE player_id = ?1 "
+        "    UNION ALL "
+        "    SELECT SUM(total_centi), SUM(session_count) FROM Session_Rollups WHERE player_id = ?1"
+        ");";
+
+    auto stmt = prepareStatement(query);
+    bindInt(stmt.get(), 1, playerId);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) throw DatabaseException("Query for a player's score totals failed");
+
+    return { sqlite3_column_int64(stmt.get(), 0), sqlite3_column_int64(stmt.get(), 1) };
+}
+
+void Database::importPlayer(const std::string& playersDbPath, int playerId) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    bool isAttached = false;
 
     try {
-        beginTransaction();
-        isTransactionActive = true;
+        const std::string attachQuery = "ATTACH DATABASE ? AS shared_players;";
+        auto attachStmt = prepareStatement(attachQuery);
+
+        bindText(attachStmt.get(), 1, playersDbPath);
+
+        if (sqlite3_step(attachStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to attach players database: " + getLastError());
+
+        isAttached = true;
+
+        // Same ID as in the shared file, so local joins and foreign keys keep working
+        const std::string importQuery =
+            "INSERT OR IGNORE INTO main.Players (player_id, player_name, created_at) "
+            "SELECT player_id, player_name, created_at FROM shared_players.Players WHERE player_id = ?;";
+        auto importStmt = prepareStatement(importQuery);
+
+        bindInt(importStmt.get(), 1, playerId);
+
+        retryOnBusy([&] {
+            int result = sqlite3_step(importStmt.get());
+
+            if (result == SQLITE_BUSY) {
+                sqlite3_reset(importStmt.get());
+                throw DatabaseBusyException("Failed to import player: " + getLastError());
+            }
+
+            if (result != SQLITE_DONE) throw DatabaseException("Failed to import player: " + getLastError());
+        });
 
-        // Get category and mode IDs
-        const std::string lookupQuery =
-            "SELECT c.category_id, m.mode_id "
-            "FROM Categories c, Game_Modes m "
-            "WHERE c.category_name = ? AND m.mode_name = ?;";
+        importStmt.reset();
+        executeQuery("DETACH DATABASE shared_players;");
+    }
+    catch (const std::exception& err) {
+        if (isAttached) sqlite3_exec(db, "DETACH DATABASE shared_players;", nullptr, nullptr, nullptr);
+
+        throw DatabaseException("Failed to import player: " + std::string(err.what()));
+    }
+}
+
+int Database::findCachedPlayerId(const std::string& playerName) {
+    auto entry = playerCacheIndex.find(playerName);
+
+    if (entry == playerCacheIndex.end()) return -1;
+
+    // Move to the front to mark as most recently used
+    playerCache.splice(playerCache.begin(), playerCache, entry->second);
+
+    return entry->second->second;
+}
+
+void Database::cachePlayerId(const std::string& playerName, int playerId) {
+    auto entry = playerCacheIndex.find(playerName);
+
+    if (entry != playerCacheIndex.end()) {
+        entry->second->second = playerId;
+        playerCache.splice(playerCache.begin(), playerCache, entry->second);
+
+        return;
+    }
+
+    playerCache.emplace_front(playerName, playerId);
+    playerCacheIndex[playerName] = playerCache.begin();
 
-        auto lookupStmt = prepareStatement(lookupQuery);
+    // Evict the least recently used player
+    if (playerCache.size() > PLAYER_CACHE_CAPACITY) {
+        playerCacheIndex.erase(playerCache.back().first);
+        playerCache.pop_back();
+    }
+}
+
+void Database::clearPlayerCache() {
+    playerCache.clear();
+    playerCacheIndex.clear();
+}
 
-        bindText(lookupStmt.get(), 1, categoryName);
-        bindText(lookupStmt.get(), 2, modeName);
+void Database::saveScore(int playerId, Category category, GameMode mode, int scoreCenti) {
+    PROFILE_SCOPE("Database::saveScore");
 
-        if (sqlite3_step(lookupStmt.get()) != SQLITE_ROW) throw DatabaseException("Invalid category or mode");
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    retryOnBusy([&] { saveScoreTransaction(playerId, category, mode, scoreCenti); });
+}
 
-        int categoryId = sqlite3_column_int(lookupStmt.get(), 0);
-        int modeId = sqlite3_column_int(lookupStmt.get(), 1);
+void Database::saveScoreTransaction(int playerId, Category category, GameMode mode, int scoreCenti) {
+    bool isTransactionActive = false;
 
-        // Insert new game session
+    try {
+        int categoryId = getCategoryId(category);
+        int modeId = getModeId(mode);
+
+        beginTransaction();
+        isTransactionActive = true;
+
+        // Insert new game session, the REAL score is kept for readers of the original schema
         const std::string sessionQuery =
-            "INSERT INTO Game_Sessions (player_id, category_id, mode_id, score) "
-            "VALUES (?, ?, ?, ?);";
+            "INSERT INTO Game_Sessions (player_id, category_id, mode_id, score, score_centi) "
+            "VALUES (?, ?, ?, ?, ?);";
 
         auto sessionStmt = prepareStatement(sessionQuery);
 
         bindInt(sessionStmt.get(), 1, playerId);
         bindInt(sessionStmt.get(), 2, categoryId);
         bindInt(sessionStmt.get(), 3, modeId);
-        bindDouble(sessionStmt.get(), 4, score);
+        bindDouble(sessionStmt.get(), 4, scoreCenti / 100.0);
+        bindInt(sessionStmt.get(), 5, scoreCenti);
 
         if (sqlite3_step(sessionStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to save game session");
 
         int sessionId = static_cast<int>(sqlite3_last_insert_rowid(db));
 
-        // Update high scores
+        // Count the session in its score bucket
+        const std::string histogramQuery =
+            "INSERT INTO Score_Histogram (category_id, mode_id, score_centi, session_count) VALUES (?, ?, ?, 1) "
+            "ON CONFLICT(category_id, mode_id, score_centi) DO UPDATE SET session_count = session_count + 1;";
+
+        auto histogramStmt = prepareStatement(histogramQuery);
+
+        bindInt(histogramStmt.get(), 1, categoryId);
+        bindInt(histogramStmt.get(), 2, modeId);
+        bindInt(histogramStmt.get(), 3, scoreCenti);
+
+        if (sqlite3_step(histogramStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to update score histogram");
+
+        updatePlayerBest(playerId, category, mode, scoreCenti);
+
+        // Update high scores and the leaderboards read by the high scores screen
+        updateWindowedScores(sessionId, categoryId, modeId);
         updateHighScores(sessionId, categoryId, modeId);
+        refreshLeaderboard(categoryId, modeId);
 
         commitTransaction();
         isTransactionActive = false;
     }
+    catch (const DatabaseBusyException&) {
+        if (isTransactionActive) rollbackTransaction();
+
+        playerBestTreesLoaded.fill(false);
+        throw;  // Left for retryOnBusy
+    }
     catch (const std::exception& err) {
         if (isTransactionActive) rollbackTransaction();
+
+        playerBestTreesLoaded.fill(false);  // Trees may hold the rolled back score
         throw DatabaseException("Failed to save score: " + std::string(err.what()));
     }
 }
 
 void Database::updateHighScores(int sessionId, int categoryId, int modeId) {
+    PROFILE_SCOPE("Database::updateHighScores");
+
     try {
-        // Check if the new score ranks in the top 10
-        const std::string rankQuery =
-            "WITH RankedScores AS ("
+        // Get the player ID and new score
+        const std::string scoreQuery =
+            "SELECT gs.player_id, gs.score_centi "
+            "FROM Game_Sessions gs "
+            "WHERE gs.session_id = ?;";
+
+        auto scoreStmt = prepareStatement(scoreQuery);
+        bindInt(scoreStmt.get(), 1, sessionId);
+
+        if (sqlite3_step(scoreStmt.get()) != SQLITE_ROW) throw DatabaseException("Could not find new score session");
+
+        int playerId = sqlite3_column_int(scoreStmt.get(), 0);
+        int newScore = sqlite3_column_int(scoreStmt.get(), 1);
+
+        // Check if the new score ranks in the top 10, equal scores do not push the newest session down
+        int rank = getScoreRank(categoryId, modeId, newScore);
+
+        if (rank <= 10) {
+            // Remove any duplicate scores in the same category & mode from the same player
+            const std::string removeDuplicateQuery =
+                "DELETE FROM High_Scores "
+                "WHERE session_id IN ("
+                "    SELECT hs.session_id "
+                "    FROM High_Scores hs "
+                "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
+                "    WHERE gs.player_id = ? "
+                "    AND gs.category_id = ? "
+                "    AND gs.mode_id = ? "
+                "    AND gs.score_centi = ? "
+                "    AND gs.session_id < ?"
+                ");";
+
+            auto removeDuplicateStmt = prepareStatement(removeDuplicateQuery);
+
+            bindInt(removeDuplicateStmt.get(), 1, playerId);
+            bindInt(removeDuplicateStmt.get(), 2, categoryId);
+            bindInt(removeDuplicateStmt.get(), 3, modeId);
+            bindInt(removeDuplicateStmt.get(), 4, newScore);
+            bindInt(removeDuplicateStmt.get(), 5, sessionId);
+
+            if (sqlite3_step(removeDuplicateStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to remove duplicate scores");
+
+            // Insert the new high score
+            const std::string insertQuery = "INSERT INTO High_Scores (session_id, rank) VALUES (?, ?);";
+
+            auto insertStmt = prepareStatement(insertQuery);
+
+            bindInt(insertStmt.get(), 1, sessionId);
+            bindInt(insertStmt.get(), 2, rank);
+
+            if (sqlite3_step(insertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to insert high score");
+
+            // Remove scores that are now outside the top 10
+            const std::string cleanupQuery =
+                "WITH RankedScores AS ("
+                "    SELECT "
+                "        hs.high_score_id, "
+                "        DENSE_RANK() OVER ("
+                "            PARTITION BY gs.category_id, gs.mode_id "
+                "            ORDER BY gs.score_centi DESC, gs.played_at DESC"
+                "        ) AS new_rank "
+                "    FROM High_Scores hs "
+                "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
+                "    WHERE gs.category_id = ? AND gs.mode_id = ?"
+                ") "
+                "DELETE FROM High_Scores "
+                "WHERE high_score_id IN ("
+                "    SELECT high_score_id FROM RankedScores WHERE new_rank > 10"
+                ");";
+
+            auto cleanupStmt = prepareStatement(cleanupQuery);
+
+            bindInt(cleanupStmt.get(), 1, categoryId);
+            bindInt(cleanupStmt.get(), 2, modeId);
+
+            if (sqlite3_step(cleanupStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to cleanup old high scores");
+        }
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to update high scores: " + std::string(err.what()));
+    }
+}
+
+int Database::getHighScoreCenti(int playerId, Category category, GameMode mode) {
+    const std::string query =
+        "SELECT gs.score_centi "
+        "FROM Game_Sessions gs "
+        "JOIN High_Scores hs ON gs.session_id = hs.session_id "
+        "WHERE gs.player_id = ? AND gs.category_id = ? AND gs.mode_id = ? "
+        "ORDER BY gs.score_centi DESC "
+        "LIMIT 1;";
+
+    auto stmt = prepareStatement(query);
+
+    bindInt(stmt.get(), 1, playerId);
+    bindInt(stmt.get(), 2, getCategoryId(category));
+    bindInt(stmt.get(), 3, getModeId(mode));
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) return sqlite3_column_int(stmt.get(), 0);
+
+    return 0;
+}
+
+int Database::getScoreRank(Category category, GameMode mode, int scoreCenti) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    return getScoreRank(getCategoryId(category), getModeId(mode), scoreCenti);
+}
+
+int Database::getScoreRank(int categoryId, int modeId, int scoreCenti) {
+    // At most one row per distinct score (51 with the current scoring rules), read straight off the primary key
+    const std::string query =
+        "SELECT COALESCE(SUM(session_count), 0) "
+        "FROM Score_Histogram "
+        "WHERE category_id = ? AND mode_id = ? AND score_centi > ?;";
+
+    auto stmt = prepareStatement(query);
+
+    bindInt(stmt.get(), 1, categoryId);
+    bindInt(stmt.get(), 2, modeId);
+    bindInt(stmt.get(), 3, scoreCenti);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) throw DatabaseException("Query for the rank of a score failed");
+
+    return static_cast<int>(sqlite3_column_int64(stmt.get(), 0)) + 1;
+}
+
+void Database::updatePlayerBest(int playerId, Category category, GameMode mode, int scoreCenti) {
+    int categoryId = getCategoryId(category);
+    int modeId = getModeId(mode);
+
+    const std::string bestQuery = "SELECT best_centi FROM Player_Best WHERE player_id = ? AND category_id = ? AND mode_id = ?;";
+    auto bestStmt = prepareStatement(bestQuery);
+
+    bindInt(bestStmt.get(), 1, playerId);
+    bindInt(bestStmt.get(), 2, categoryId);
+    bindInt(bestStmt.get(), 3, modeId);
+
+    int oldBest = -1;
+
+    if (sqlite3_step(bestStmt.get()) == SQLITE_ROW) oldBest = sqlite3_column_int(bestStmt.get(), 0);
+    if (scoreCenti <= oldBest) return;
+
+    const std::string upsertQuery =
+        "INSERT INTO Player_Best (player_id, category_id, mode_id, best_centi) VALUES (?, ?, ?, ?) "
+        "ON CONFLICT(player_id, category_id, mode_id) DO UPDATE SET best_centi = excluded.best_centi;";
+    auto upsertStmt = prepareStatement(upsertQuery);
+
+    bindInt(upsertStmt.get(), 1, playerId);
+    bindInt(upsertStmt.get(), 2, categoryId);
+    bindInt(upsertStmt.get(), 3, modeId);
+    bindInt(upsertStmt.get(), 4, scoreCenti);
+
+    if (sqlite3_step(upsertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to update player best score");
+
+    // Move the player from the old best's bucket to the new one
+    const std::string histogramQuery =
+        "INSERT INTO Player_Best_Histogram (category_id, mode_id, score_centi, player_count) VALUES (?, ?, ?, ?) "
+        "ON CONFLICT(category_id, mode_id, score_centi) DO UPDATE SET player_count = player_count + excluded.player_count;";
+    auto histogramStmt = prepareStatement(histogramQuery);
+
+    for (const std::pair<int, int>& change : { std::make_pair(oldBest, -1), std::make_pair(scoreCenti, 1) }) {
+        if (change.first < 0) continue;
+
+        bindInt(histogramStmt.get(), 1, categoryId);
+        bindInt(histogramStmt.get(), 2, modeId);
+        bindInt(histogramStmt.get(), 3, change.first);
+        bindInt(histogramStmt.get(), 4, change.second);
+
+        if (sqlite3_step(histogramStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to update player best histogram");
+
+        sqlite3_reset(histogramStmt.get());
+    }
+
+    // Keep a loaded tree in step, saveScore drops the trees if its transaction rolls back
+    int treeIndex = (static_cast<int>(category) * MODE_COUNT) + static_cast<int>(mode);
+
+    if (playerBestTreesLoaded[treeIndex]) {
+        if (oldBest >= 0) playerBestTrees[treeIndex].add(oldBest, -1);
+        playerBestTrees[treeIndex].add(scoreCenti, 1);
+    }
+}
+
+void Database::updateWindowedScores(int sessionId, int categoryId, int modeId) {
+    const std::string sessionQuery = "SELECT player_id, score_centi, CAST(strftime('%s', played_at) AS INTEGER) FROM Game_Sessions WHERE session_id = ?;";
+    auto sessionStmt = prepareStatement(sessionQuery);
+
+    bindInt(sessionStmt.get(), 1, sessionId);
+
+    if (sqlite3_step(sessionStmt.get()) != SQLITE_ROW) throw DatabaseException("Could not find new score session");
+
+    int playerId = sqlite3_column_int(sessionStmt.get(), 0);
+    int scoreCenti = sqlite3_column_int(sessionStmt.get(), 1);
+    long long playedAt = sqlite3_column_int64(sessionStmt.get(), 2);
+
+    // Same player with the same score keeps only the newer session, as in High_Scores
+    const std::string duplicateQuery =
+        "DELETE FROM Windowed_Scores "
+        "WHERE window_type = ? AND bucket_start = ? AND category_id = ? AND mode_id = ? AND player_id = ? AND score_centi = ?;";
+    auto duplicateStmt = prepareStatement(duplicateQuery);
+
+    const std::string insertQuery =
+        "INSERT INTO Windowed_Scores (window_type, bucket_start, category_id, mode_id, session_id, player_id, score_centi, played_at) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+    auto insertStmt = prepareStatement(insertQuery);
+
+    // A bucket never holds more than 11 rows here, so ranking it is trivial
+    const std::string pruneQuery =
+        "DELETE FROM Windowed_Scores "
+        "WHERE window_type = ?1 AND bucket_start = ?2 AND category_id = ?3 AND mode_id = ?4 AND session_id IN ("
+        "    SELECT session_id FROM ("
+        "        SELECT session_id, ROW_NUMBER() OVER (ORDER BY score_centi DESC, played_at ASC, session_id ASC) AS position "
+        "        FROM Windowed_Scores "
+        "        WHERE window_type = ?1 AND bucket_start = ?2 AND category_id = ?3 AND mode_id = ?4"
+        "    ) WHERE position > 10"
+        ");";
+    auto pruneStmt = prepareStatement(pruneQuery);
+
+    const std::string expireQuery = "DELETE FROM Windowed_Scores WHERE window_type = ? AND bucket_start < ?;";
+    auto expireStmt = prepareStatement(expireQuery);
+
+    for (LeaderboardWindow window : { LeaderboardWindow::DAILY, LeaderboardWindow::WEEKLY }) {
+        int windowType = static_cast<int>(window);
+        long long bucketStart = getWindowStart(window, playedAt);
+        long long bucketLength = (window == LeaderboardWindow::DAILY) ? SECONDS_PER_DAY : (7 * SECONDS_PER_DAY);
+        int bucketsKept = (window == LeaderboardWindow::DAILY) ? DAILY_BUCKETS_KEPT : WEEKLY_BUCKETS_KEPT;
+
+        bindInt(duplicateStmt.get(), 1, windowType);
+        bindInt64(duplicateStmt.get(), 2, bucketStart);
+        bindInt(duplicateStmt.get(), 3, categoryId);
+        bindInt(duplicateStmt.get(), 4, modeId);
+        bindInt(duplicateStmt.get(), 5, playerId);
+        bindInt(duplicateStmt.get(), 6, scoreCenti);
+
+        if (sqlite3_step(duplicateStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to remove duplicate windowed score");
+
+        sqlite3_reset(duplicateStmt.get());
+
+        bindInt(insertStmt.get(), 1, windowType);
+        bindInt64(insertStmt.get(), 2, bucketStart);
+        bindInt(insertStmt.get(), 3, categoryId);
+        bindInt(insertStmt.get(), 4, modeId);
+        bindInt(insertStmt.get(), 5, sessionId);
+        bindInt(insertStmt.get(), 6, playerId);
+        bindInt(insertStmt.get(), 7, scoreCenti);
+        bindInt64(insertStmt.get(), 8, playedAt);
+
+        if (sqlite3_step(insertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to insert windowed score");
+
+        sqlite3_reset(insertStmt.get());
+
+        bindInt(pruneStmt.get(), 1, windowType);
+        bindInt64(pruneStmt.get(), 2, bucketStart);
+        bindInt(pruneStmt.get(), 3, categoryId);
+        bindInt(pruneStmt.get(), 4, modeId);
+
+        if (sqlite3_step(pruneStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to prune windowed scores");
+
+        sqlite3_reset(pruneStmt.get());
+
+        // Expire whole buckets that have aged out
+        bindInt(expireStmt.get(), 1, windowType);
+        bindInt64(expireStmt.get(), 2, bucketStart - (bucketsKept * bucketLength));
+
+        if (sqlite3_step(expireStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to expire windowed scores");
+
+        sqlite3_reset(expireStmt.get());
+    }
+}
+
+long long Database::getWindowStart(LeaderboardWindow window, long long unixTime) {
+    if (window == LeaderboardWindow::DAILY) return unixTime - (unixTime % SECONDS_PER_DAY);
+
+    // The Unix epoch fell on a Thursday, so Mondays are 4 days off a multiple of 7 days
+    const long long weekLength = 7 * SECONDS_PER_DAY;
+    const long long mondayOffset = 4 * SECONDS_PER_DAY;
+
+    return unixTime - ((unixTime - mondayOffset) % weekLength);
+}
+
+std::vector<std::tuple<std::string, int, int>> Database::getWindowedScores(Category category, GameMode mode, LeaderboardWindow window, int limit) {
+    // Primary key range read of the current bucket, at most 10 rows
+    const std::string query =
+        "SELECT p.player_name, w.score_centi, COUNT(*) OVER (PARTITION BY w.score_centi) "
+        "FROM Windowed_Scores w "
+        "JOIN Players p ON w.player_id = p.player_id "
+        "WHERE w.window_type = ? AND w.bucket_start = ? AND w.category_id = ? AND w.mode_id = ? "
+        "ORDER BY w.score_centi DESC, w.played_at ASC, w.session_id ASC "
+        "LIMIT ?;";
+
+    auto stmt = prepareStatement(query);
+
+    bindInt(stmt.get(), 1, static_cast<int>(window));
+    bindInt64(stmt.get(), 2, getWindowStart(window, static_cast<long long>(std::time(nullptr))));
+    bindInt(stmt.get(), 3, getCategoryId(category));
+    bindInt(stmt.get(), 4, getModeId(mode));
+    bindInt(stmt.get(), 5, limit);
+
+    std::vector<std::tuple<std::string, int, int>> scores;
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+
+        scores.emplace_back(name, sqlite3_column_int(stmt.get(), 1), sqlite3_column_int(stmt.get(), 2));
+    }
+
+    return scores;
+}
+
+int Database::getPlayerRank(int playerId, Category category, GameMode mode) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    const std::string query = "SELECT best_centi FROM Player_Best WHERE player_id = ? AND category_id = ? AND mode_id = ?;";
+    auto stmt = prepareStatement(query);
+
+    bindInt(stmt.get(), 1, playerId);
+    bindInt(stmt.get(), 2, getCategoryId(category));
+    bindInt(stmt.get(), 3, getModeId(mode));
+
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) return -1;
+
+    int best = sqlite3_column_int(stmt.get(), 0);
+
+    return static_cast<int>(getPlayerBestTree(category, mode).countAbove(best)) + 1;
+}
+
+double Database::getPercentile(int scoreCenti, Category category, GameMode mode) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+    if ((scoreCenti < 0) || (scoreCenti > MAX_SCORE_CENTI)) throw DatabaseException("Score is out of range");
+
+    const ScoreCountTree& tree = getPlayerBestTree(category, mode);
+
+    if (tree.getTotal() == 0) return 0.0;
+
+    double below = static_cast<double>(tree.countBelow(scoreCenti)) + (0.5 * tree.countAt(scoreCenti));
+
+    return (100.0 * below) / tree.getTotal();
+}
+
+ScoreCountTree& Database::getPlayerBestTree(Category category, GameMode mode) {
+    int categoryIndex = static_cast<int>(category);
+    int modeIndex = static_cast<int>(mode);
+
+    if ((categoryIndex < 0) || (categoryIndex >= CATEGORY_COUNT) || (modeIndex < 0) || (modeIndex >= MODE_COUNT)) throw DatabaseException("Invalid category or game mode");
+
+    int treeIndex = (categoryIndex * MODE_COUNT) + modeIndex;
+
+    // Long-lived connections see other connections' saves here, this connection's own saves update the trees directly
+    int dataVersion = getPragmaInt("data_version");
+
+    if (dataVersion != playerBestDataVersion) {
+        playerBestTreesLoaded.fill(false);
+        playerBestDataVersion = dataVersion;
+    }
+
+    if (!playerBestTreesLoaded[treeIndex]) {
+        // One row per distinct best score, so loading is cheap and queries after it are O(log n)
+        ScoreCountTree tree(MAX_SCORE_CENTI);
+
+        const std::string query = "SELECT score_centi, player_count FROM Player_Best_Histogram WHERE category_id = ? AND mode_id = ?;";
+        auto stmt = prepareStatement(query);
+
+        bindInt(stmt.get(), 1, getCategoryId(category));
+        bindInt(stmt.get(), 2, getModeId(mode));
+
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) tree.add(sqlite3_column_int(stmt.get(), 0), sqlite3_column_int64(stmt.get(), 1));
+
+        playerBestTrees[treeIndex] = std::move(tree);
+        playerBestTreesLoaded[treeIndex] = true;
+    }
+
+    return playerBestTrees[treeIndex];
+}
+
+void Database::refreshLeaderboard(int categoryId, int modeId) {
+    try {
+        const std::string deleteQuery = "DELETE FROM Leaderboard WHERE category_id = ? AND mode_id = ?;";
+
+        auto deleteStmt = prepareStatement(deleteQuery);
+
+        bindInt(deleteStmt.get(), 1, categoryId);
+        bindInt(deleteStmt.get(), 2, modeId);
+
+        if (sqlite3_step(deleteStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to clear leaderboard");
+
+        // Rank the (at most 10) High_Scores rows of this category-mode once, at write time
+        const std::string insertQuery =
+            "INSERT INTO Leaderboard (category_id, mode_id, rank, session_id, player_name, score_centi, played_at, tie_count) "
+            "SELECT category_id, mode_id, sequential_rank, session_id, player_name, score_centi, played_at, tie_count "
+            "FROM ("
             "    SELECT "
+            "        gs.category_id, "
+            "        gs.mode_id, "
             "        gs.session_id, "
-            "        DENSE_RANK() OVER ("
-            "            PARTITION BY gs.category_id, gs.mode_id "
-            "            ORDER BY gs.score DESC, gs.played_at DESC"
-            "        ) AS rank "
-            "    FROM Game_Sessions gs "
+            "        p.player_name, "
+            "        gs.score_centi, "
+            "        gs.played_at, "
+            "        ROW_NUMBER() OVER (ORDER BY gs.score_centi DESC, gs.played_at DESC) AS sequential_rank, "
+            "        COUNT(*) OVER (PARTITION BY gs.score_centi) AS tie_count "
+            "    FROM High_Scores hs "
+            "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
+            "    JOIN Players p ON gs.player_id = p.player_id "
             "    WHERE gs.category_id = ? AND gs.mode_id = ?"
             ") "
-            "SELECT rank FROM RankedScores WHERE session_id = ?;";
+            "WHERE sequential_rank <= 10;";
 
-        auto rankStmt = prepareStatement(rankQuery);
+        auto insertStmt = prepareStatement(insertQuery);
 
-        bindInt(rankStmt.get(), 1, categoryId);
-        bindInt(rankStmt.get(), 2, modeId);
-        bindInt(rankStmt.get(), 3, sessionId);
+        bindInt(insertStmt.get(), 1, categoryId);
+        bindInt(insertStmt.get(), 2, modeId);
 
-        if (sqlite3_step(rankStmt.get()) == SQLITE_ROW) {
-            int rank = sqlite3_column_int(rankStmt.get(), 0);
+        if (sqlite3_step(insertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to fill leaderboard");
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to refresh leaderboard: " + std::string(err.what()));
+    }
+}
 
-            if (rank <= 10) {
-                // Get the player ID and new score
-                const std::string scoreQuery =
-                    "SELECT gs.player_id, gs.score "
-                    "FROM Game_Sessions gs "
-                    "WHERE gs.session_id = ?;";
+std::size_t Database::rebuildHighScores(const std::function<void(std::size_t, std::size_t)>& onProgress) {
+    PROFILE_SCOPE("Database::rebuildHighScores");
 
-                auto scoreStmt = prepareStatement(scoreQuery);
-                bindInt(scoreStmt.get(), 1, sessionId);
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
 
-                if (sqlite3_step(scoreStmt.get()) != SQLITE_ROW) throw DatabaseException("Could not find new score session");
+    // One top 10 candidate, ordered like the high scores screen: score, then newest first
+    struct Candidate {
+        long long sessionId;
+        int playerId;
+        int scoreCenti;
+        std::string playedAt;  // SQLite timestamp text, which sorts chronologically
+    };
+
+    auto ranksHigher = [](const Candidate& a, const Candidate& b) {
+        if (a.scoreCenti != b.scoreCenti) return a.scoreCenti > b.scoreCenti;
+        if (a.playedAt != b.playedAt) return a.playedAt > b.playedAt;
+        return a.sessionId > b.sessionId;
+    };
+
+    /*
+    Per category-mode top of the table. A player keeps only their newest session per score, so whether
+    a score can still make the top 10 depends on how many (player, score) pairs rank above it, not on
+    which session ends up representing each pair. Score levels are dropped as soon as 10 pairs outrank
+    them, and the final top 10 is picked from the few levels left.
+    */
+    struct PartitionTop {
+        std::map<int, std::unordered_map<int, Candidate>, std::greater<int>> levels;  // Score to newest session per player
+        std::size_t pairCount = 0;
+    };
+
+    std::map<std::pair<int, int>, PartitionTop> topScores;
+    std::size_t sessionsRead = 0;
+    bool isTransactionActive = false;
 
-                int playerId = sqlite3_column_int(scoreStmt.get(), 0);
-                double newScore = sqlite3_column_double(scoreStmt.get(), 1);
+    try {
+        beginTransaction();
+        isTransactionActive = true;
+
+        std::size_t totalSessions = 0;
+
+        if (onProgress) {
+            auto countStmt = prepareStatement("SELECT COUNT(*) FROM Game_Sessions;");
+
+            if (sqlite3_step(countStmt.get()) == SQLITE_ROW) totalSessions = static_cast<std::size_t>(sqlite3_column_int64(countStmt.get(), 0));
+        }
+
+        // A single scan in primary key order, nothing for SQLite to sort
+        const std::string scanQuery =
+            "SELECT session_id, player_id, category_id, mode_id, score_centi, played_at "
+            "FROM Game_Sessions "
+            "ORDER BY session_id;";
+
+        auto scanStmt = prepareStatement(scanQuery);
+        int stepResult;
+
+        while ((stepResult = sqlite3_step(scanStmt.get())) == SQLITE_ROW) {
+            int scoreCenti = sqlite3_column_int(scanStmt.get(), 4);
+            PartitionTop& top = topScores[{ sqlite3_column_int(scanStmt.get(), 2), sqlite3_column_int(scanStmt.get(), 3) }];
+
+            // Below every kept level with 10 pairs above it, the session cannot rank, which is most sessions
+            bool isOutranked = (top.pairCount >= 10) && (scoreCenti < top.levels.rbegin()->first);
+
+            if (!isOutranked) {
+                Candidate candidate;
+                candidate.sessionId = sqlite3_column_int64(scanStmt.get(), 0);
+                candidate.playerId = sqlite3_column_int(scanStmt.get(), 1);
+                candidate.scoreCenti = scoreCenti;
+                candidate.playedAt = reinterpret_cast<const char*>(sqlite3_column_text(scanStmt.get(), 5));
+
+                auto& level = top.levels[scoreCenti];
+
+                // Sessions arrive oldest first, so this replaces the player's older session with the same score
+                bool isNewPair = level.insert_or_assign(candidate.playerId, std::move(candidate)).second;
+
+                if (isNewPair) top.pairCount++;
+
+                while ((top.levels.size() > 1) && (top.pairCount - top.levels.rbegin()->second.size() >= 10)) {
+                    top.pairCount -= top.levels.rbegin()->second.size();
+                    top.levels.erase(std::prev(top.levels.end()));
+                }
+            }
 
-                // Remove any duplicate scores in the same category & mode from the same player
-                const std::string removeDuplicateQuery =
-                    "DELETE FROM High_Scores "
-                    "WHERE session_id IN ("
-                    "    SELECT hs.session_id "
-                    "    FROM High_Scores hs "
-                    "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
-                    "    WHERE gs.player_id = ? "
-                    "    AND gs.category_id = ? "
-                    "    AND gs.mode_id = ? "
-                    "    AND gs.score = ? "
-                    "    AND gs.session_id < ?"
-                    ");";
+            sessionsRead++;
 
-                auto removeDuplicateStmt = prepareStatement(removeDuplicateQuery);
+            if (onProgress && ((sessionsRead % REBUILD_PROGRESS_INTERVAL) == 0)) onProgress(sessionsRead, totalSessions);
+        }
+
+        if (stepResult != SQLITE_DONE) throw DatabaseException("Failed to read game sessions");
 
-                bindInt(removeDuplicateStmt.get(), 1, playerId);
-                bindInt(removeDuplicateStmt.get(), 2, categoryId);
-                bindInt(removeDuplicateStmt.get(), 3, modeId);
-                bindDouble(removeDuplicateStmt.get(), 4, newScore);
-                bindInt(removeDuplicateStmt.get(), 5, sessionId);
+        executeQuery("DELETE FROM High_Scores;");
+
+        const std::string insertQuery = "INSERT INTO High_Scores (session_id, rank) VALUES (?, ?);";
+        auto insertStmt = prepareStatement(insertQuery);
 
-                if (sqlite3_step(removeDuplicateStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to remove duplicate scores");
+        for (const auto& [partition, top] : topScores) {
+            std::vector<Candidate> ranked;
 
-                // Insert the new high score
-                const std::string insertQuery = "INSERT INTO High_Scores (session_id, rank) VALUES (?, ?);";
+            for (const auto& [score, players] : top.levels) {
+                for (const auto& [playerId, candidate] : players) ranked.push_back(candidate);
+            }
 
-                auto insertStmt = prepareStatement(insertQuery);
+            std::sort(ranked.begin(), ranked.end(), ranksHigher);
 
-                bindInt(insertStmt.get(), 1, sessionId);
-                bindInt(insertStmt.get(), 2, rank);
+            for (std::size_t i = 0; (i < ranked.size()) && (i < 10); i++) {
+                bindInt64(insertStmt.get(), 1, ranked[i].sessionId);
+                bindInt(insertStmt.get(), 2, static_cast<int>(i) + 1);
 
                 if (sqlite3_step(insertStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to insert high score");
 
-                // Remove scores that are now outside the top 10
-                const std::string cleanupQuery =
-                    "WITH RankedScores AS ("
-                    "    SELECT "
-                    "        hs.high_score_id, "
-                    "        DENSE_RANK() OVER ("
-                    "            PARTITION BY gs.category_id, gs.mode_id "
-                    "            ORDER BY gs.score DESC, gs.played_at DESC"
-                    "        ) AS new_rank "
-                    "    FROM High_Scores hs "
-                    "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
-                    "    WHERE gs.category_id = ? AND gs.mode_id = ?"
-                    ") "
-                    "DELETE FROM High_Scores "
-                    "WHERE high_score_id IN ("
-                    "    SELECT high_score_id FROM RankedScores WHERE new_rank > 10"
-                    ");";
-
-                auto cleanupStmt = prepareStatement(cleanupQuery);
-
-                bindInt(cleanupStmt.get(), 1, categoryId);
-                bindInt(cleanupStmt.get(), 2, modeId);
-
-                if (sqlite3_step(cleanupStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to cleanup old high scores");
+                sqlite3_reset(insertStmt.get());
             }
         }
-        else {
-            throw DatabaseException("Query for the rank of the new score failed");
+
+        // Every category-mode, so partitions without sessions end up empty too
+        const std::string partitionQuery = "SELECT c.category_id, m.mode_id FROM Categories c, Game_Modes m;";
+        auto partitionStmt = prepareStatement(partitionQuery);
+
+        while (sqlite3_step(partitionStmt.get()) == SQLITE_ROW) {
+            refreshLeaderboard(sqlite3_column_int(partitionStmt.get(), 0), sqlite3_column_int(partitionStmt.get(), 1));
         }
+
+        commitTransaction();
+        isTransactionActive = false;
+
+        if (onProgress) onProgress(sessionsRead, totalSessions);
     }
     catch (const std::exception& err) {
-        throw DatabaseException("Failed to update high scores: " + std::string(err.what()));
+        if (isTransactionActive) rollbackTransaction();
+        throw DatabaseException("Failed to rebuild high scores: " + std::string(err.what()));
     }
+
+    return sessionsRead;
 }
 
-double Database::getHighScore(int playerId, const std::string& categoryName, const std::string& modeName) {
-    const std::string query =
-        "SELECT gs.score "
-        "FROM Game_Sessions gs "
-        "JOIN Categories c ON gs.category_id = c.category_id "
-        "JOIN Game_Modes m ON gs.mode_id = m.mode_id "
-        "JOIN High_Scores hs ON gs.session_id = hs.session_id "
-        "WHERE gs.player_id = ? AND c.category_name = ? AND m.mode_name = ? "
-        "ORDER BY gs.score DESC "
-        "LIMIT 1;";
+std::vector<std::string> Database::getHighScores(Category category, GameMode mode, LeaderboardWindow window) {
+    std::vector<std::string> formattedScores;
 
-    auto stmt = prepareStatement(query);
+    if (window != LeaderboardWindow::ALL_TIME) {
+        try {
+            int sequentialRank = 0;
 
-    bindInt(stmt.get(), 1, playerId);
-    bindText(stmt.get(), 2, categoryName);
-    bindText(stmt.get(), 3, modeName);
+            for (const auto& [name, scoreCenti, tieCount] : getWindowedScores(category, mode, window, 10)) {
+                std::ostringstream ss;
 
-    if (sqlite3_step(stmt.get()) == SQLITE_ROW) return sqlite3_column_double(stmt.get(), 0);
+                ss << std::setw(2) << ++sequentialRank << ". "
+                    << std::left << std::setw(20) << name
+                    << std::right << std::fixed << std::setprecision(2) << (scoreCenti / 100.0);
 
-    return 0.0;
-}
+                if (tieCount > 1) ss << " (tie)";
 
-std::vector<std::string> Database::getHighScores(const std::string& categoryName, const std::string& modeName) {
-    std::vector<std::string> formattedScores;
-    bool isTransactionActive = false;
+                formattedScores.push_back(ss.str());
+            }
+        }
+        catch (const std::exception& err) {
+            throw DatabaseException("Failed to get formatted high scores: " + std::string(err.what()));
+        }
+
+        return formattedScores;
+    }
+
+    // Primary key range scan over the precomputed leaderboard rows
     const std::string query =
-        "WITH RankedScores AS ("
-        "    SELECT "
-        "        p.player_name, "
-        "        gs.score, "
-        "        DENSE_RANK() OVER (ORDER BY gs.score DESC) as dense_rank, "
-        "        ROW_NUMBER() OVER (ORDER BY gs.score DESC, gs.played_at DESC) as sequential_rank, "
-        "        COUNT(*) OVER (PARTITION BY gs.score) as tie_count, "
-        "        ROW_NUMBER() OVER (PARTITION BY gs.score ORDER BY gs.played_at DESC) as tiebreaker "
-        "    FROM High_Scores hs "
-        "    JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
-        "    JOIN Players p ON gs.player_id = p.player_id "
-        "    JOIN Categories c ON gs.category_id = c.category_id "
-        "    JOIN Game_Modes m ON gs.mode_id = m.mode_id "
-        "    WHERE c.category_name = ? AND m.mode_name = ? "
-        ") "
-        "SELECT "
-        "    player_name, "
-        "    score, "
-        "    dense_rank, "
-        "    sequential_rank, "
-        "    tie_count, "
-        "    tiebreaker "
-        "FROM RankedScores "
-        "ORDER BY score DESC, tiebreaker ASC "
-        "LIMIT 10;";
+        "SELECT l.rank, l.player_name, l.score_centi, l.tie_count "
+        "FROM Leaderboard l "
+        "WHERE l.category_id = ? AND l.mode_id = ? "
+        "ORDER BY l.rank;";
 
     try {
-        beginTransaction();
-        isTransactionActive = true;
-
         auto stmt = prepareStatement(query);
 
-        bindText(stmt.get(), 1, categoryName);
-        bindText(stmt.get(), 2, modeName);
+        bindInt(stmt.get(), 1, getCategoryId(category));
+        bindInt(stmt.get(), 2, getModeId(mode));
 
         while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
-            double score = sqlite3_column_double(stmt.get(), 1);
-            int sequentialRank = sqlite3_column_int(stmt.get(), 3);
-            int tieCount = sqlite3_column_int(stmt.get(), 4);
+            int sequentialRank = sqlite3_column_int(stmt.get(), 0);
+            std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+            int scoreCenti = sqlite3_column_int(stmt.get(), 2);
+            int tieCount = sqlite3_column_int(stmt.get(), 3);
 
             std::ostringstream ss;
 
             ss << std::setw(2) << sequentialRank << ". "
                 << std::left << std::setw(20) << name
-                << std::right << std::fixed << std::setprecision(2) << score;
+                << std::right << std::fixed << std::setprecision(2) << (scoreCenti / 100.0);
 
             // Add tie indicator if there are ties for this score
             if (tieCount > 1) {
@@ -536,48 +1737,338 @@ std::vector<std::string> Database::getHighScores(const std::string& categoryName
 
             formattedScores.push_back(ss.str());
         }
-
-        commitTransaction();
-        isTransactionActive = false;
     }
     catch (const std::exception& err) {
-        if (isTransactionActive) rollbackTransaction();
         throw DatabaseException("Failed to get formatted high scores: " + std::string(err.what()));
     }
 
     return formattedScores;
 }
 
-std::vector<std::pair<std::string, double>> Database::getTopScores(const std::string& categoryName, const std::string& modeName, int limit) {
+std::vector<std::pair<std::string, int>> Database::getTopScores(Category category, GameMode mode, int limit, LeaderboardWindow window) {
+    if (window != LeaderboardWindow::ALL_TIME) {
+        std::vector<std::pair<std::string, int>> scores;
+
+        for (const auto& [name, scoreCenti, tieCount] : getWindowedScores(category, mode, window, limit)) scores.emplace_back(name, scoreCenti);
+
+        return scores;
+    }
+
     const std::string query =
-        "SELECT p.player_name, gs.score "
-        "FROM High_Scores hs "
-        "JOIN Game_Sessions gs ON hs.session_id = gs.session_id "
-        "JOIN Players p ON gs.player_id = p.player_id "
-        "JOIN Categories c ON gs.category_id = c.category_id "
-        "JOIN Game_Modes m ON gs.mode_id = m.mode_id "
-        "WHERE c.category_name = ? AND m.mode_name = ? "
-        "ORDER BY gs.score DESC, gs.played_at ASC "
+        "SELECT l.player_name, l.score_centi "
+        "FROM Leaderboard l "
+        "WHERE l.category_id = ? AND l.mode_id = ? "
+        "ORDER BY l.score_centi DESC, l.played_at ASC "
         "LIMIT ?;";
 
     auto stmt = prepareStatement(query);
 
-    bindText(stmt.get(), 1, categoryName);
-    bindText(stmt.get(), 2, modeName);
+    bindInt(stmt.get(), 1, getCategoryId(category));
+    bindInt(stmt.get(), 2, getModeId(mode));
     bindInt(stmt.get(), 3, limit);
 
-    std::vector<std::pair<std::string, double>> scores;
+    std::vector<std::pair<std::string, int>> scores;
 
     while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
         std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
-        double score = sqlite3_column_double(stmt.get(), 1);
+        int scoreCenti = sqlite3_column_int(stmt.get(), 1);
 
-        scores.emplace_back(name, score);
+        scores.emplace_back(name, scoreCenti);
     }
 
     return scores;
 }
 
+std::size_t Database::compactSessions(int retentionDays, std::size_t maxSessions) {
+    PROFILE_SCOPE("Database::compactSessions");
+
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+    if (retentionDays < 1) throw DatabaseException("Retention period must be at least one day");
+    if (maxSessions == 0) return 0;
+
+    // Sessions a leaderboard points at stay whole, Leaderboard rows only ever come from High_Scores
+    const std::string eligibleCondition =
+        "gs.played_at < ?1 "
+        "AND NOT EXISTS (SELECT 1 FROM High_Scores hs WHERE hs.session_id = gs.session_id) "
+        "AND NOT EXISTS (SELECT 1 FROM Windowed_Scores ws WHERE ws.session_id = gs.session_id)";
+
+    bool isTransactionActive = false;
+
+    try {
+        // One cutoff for every statement of the batch
+        const std::string cutoffQuery = "SELECT datetime('now', ?);";
+        auto cutoffStmt = prepareStatement(cutoffQuery);
+
+        bindText(cutoffStmt.get(), 1, "-" + std::to_string(retentionDays) + " days");
+
+        if (sqlite3_step(cutoffStmt.get()) != SQLITE_ROW) throw DatabaseException("Could not compute the retention cutoff");
+
+        std::string cutoff = reinterpret_cast<const char*>(sqlite3_column_text(cutoffStmt.get(), 0));
+
+        // The batch is the oldest eligible sessions up to this ID, which keeps every later statement to the same rows
+        const std::string boundQuery =
+            "SELECT MAX(session_id) FROM ("
+            "    SELECT gs.session_id FROM Game_Sessions gs WHERE " + eligibleCondition + " ORDER BY gs.session_id LIMIT ?2"
+            ");";
+        auto boundStmt = prepareStatement(boundQuery);
+
+        bindText(boundStmt.get(), 1, cutoff);
+        bindInt64(boundStmt.get(), 2, static_cast<long long>(maxSessions));
+
+        if ((sqlite3_step(boundStmt.get()) != SQLITE_ROW) || (sqlite3_column_type(boundStmt.get(), 0) == SQLITE_NULL)) return 0;
+
+        long long lastSessionId = sqlite3_column_int64(boundStmt.get(), 0);
+
+        beginTransaction();
+        isTransactionActive = true;
+
+        const std::string rollupQuery =
+            "INSERT INTO Session_Rollups (player_id, category_id, mode_id, play_date, session_count, total_centi, best_centi, worst_centi) "
+            "SELECT gs.player_id, gs.category_id, gs.mode_id, date(gs.played_at), COUNT(*), SUM(gs.score_centi), MAX(gs.score_centi), MIN(gs.score_centi) "
+            "FROM Game_Sessions gs "
+            "WHERE " + eligibleCondition + " AND gs.session_id <= ?2 "
+            "GROUP BY gs.player_id, gs.category_id, gs.mode_id, date(gs.played_at) "
+            "ON CONFLICT(player_id, category_id, mode_id, play_date) DO UPDATE SET "
+            "    session_count = session_count + excluded.session_count, "
+            "    total_centi = total_centi + excluded.total_centi, "
+            "    best_centi = MAX(best_centi, excluded.best_centi), "
+            "    worst_centi = MIN(worst_centi, excluded.worst_centi);";
+        auto rollupStmt = prepareStatement(rollupQuery);
+
+        bindText(rollupStmt.get(), 1, cutoff);
+        bindInt64(rollupStmt.get(), 2, lastSessionId);
+
+        if (sqlite3_step(rollupStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to roll up sessions");
+
+        const std::string deleteQuery =
+            "DELETE FROM Game_Sessions WHERE session_id IN ("
+            "    SELECT gs.session_id FROM Game_Sessions gs WHERE " + eligibleCondition + " AND gs.session_id <= ?2"
+            ");";
+        auto deleteStmt = prepareStatement(deleteQuery);
+
+        bindText(deleteStmt.get(), 1, cutoff);
+        bindInt64(deleteStmt.get(), 2, lastSessionId);
+
+        if (sqlite3_step(deleteStmt.get()) != SQLITE_DONE) throw DatabaseException("Failed to delete compacted sessions");
+
+        std::size_t compacted = static_cast<std::size_t>(sqlite3_changes(db));
+
+        commitTransaction();
+        isTransactionActive = false;
+
+        return compacted;
+    }
+    catch (const std::exception& err) {
+        if (isTransactionActive) rollbackTransaction();
+        throw DatabaseException("Failed to compact sessions: " + std::string(err.what()));
+    }
+}
+
+int Database::incrementalVacuum(int pageCount) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    try {
+        executeQuery("PRAGMA incremental_vacuum(" + std::to_string(std::max(pageCount, 1)) + ");");
+
+        return getPragmaInt("freelist_count");
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to vacuum database: " + std::string(err.what()));
+    }
+}
+
+std::size_t Database::streamGameSessions(const std::function<void(const std::vector<SessionRecord>&)>& onChunk, std::size_t chunkSize) {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+    if (chunkSize == 0) throw DatabaseException("Export chunk size must be positive");
+
+    // Keyset pagination: every chunk is a short primary key range read, so no lock is held across the whole export
+    const std::string query =
+        "SELECT gs.session_id, gs.player_id, p.player_name, gs.category_id, c.category_name, "
+        "    gs.mode_id, m.mode_name, gs.score_centi, CAST(strftime('%s', gs.played_at) AS INTEGER) "
+        "FROM Game_Sessions gs "
+        "JOIN Players p ON gs.player_id = p.player_id "
+        "JOIN Categories c ON gs.category_id = c.category_id "
+        "JOIN Game_Modes m ON gs.mode_id = m.mode_id "
+        "WHERE gs.session_id > ? "
+        "ORDER BY gs.session_id "
+        "LIMIT ?;";
+
+    std::size_t totalRows = 0;
+    long long lastSessionId = 0;
+    std::vector<SessionRecord> chunk;
+    chunk.reserve(chunkSize);
+
+    try {
+        auto stmt = prepareStatement(query);
+
+        while (true) {
+            chunk.clear();
+
+            bindInt64(stmt.get(), 1, lastSessionId);
+            bindInt(stmt.get(), 2, static_cast<int>(chunkSize));
+
+            while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+                SessionRecord record;
+
+                record.sessionId = sqlite3_column_int64(stmt.get(), 0);
+                record.playerId = sqlite3_column_int(stmt.get(), 1);
+                record.playerName = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+                record.categoryId = sqlite3_column_int(stmt.get(), 3);
+                record.categoryName = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
+                record.modeId = sqlite3_column_int(stmt.get(), 5);
+                record.modeName = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 6));
+                record.scoreCenti = sqlite3_column_int(stmt.get(), 7);
+                record.playedAt = sqlite3_column_int64(stmt.get(), 8);
+
+                chunk.push_back(std::move(record));
+            }
+
+            sqlite3_reset(stmt.get());
+
+            if (chunk.empty()) break;
+
+            lastSessionId = chunk.back().sessionId;
+            totalRows += chunk.size();
+
+            onChunk(chunk);
+
+            if (chunk.size() < chunkSize) break;
+        }
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to stream game sessions: " + std::string(err.what()));
+    }
+
+    return totalRows;
+}
+
+void Database::setQueryProfiling(bool enabled) {
+    queryProfilingEnabled = enabled;
+
+    if (isOpen()) {
+        if (enabled) registerTrace();
+        else sqlite3_trace_v2(db, 0, nullptr, nullptr);
+    }
+}
+
+void Database::registerTrace() {
+    int result = sqlite3_trace_v2(db, SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW, &Database::traceCallback, this);
+    checkError(result, "Registering query profiler");
+}
+
+int Database::traceCallback(unsigned int type, void* context, void* p, void* x) {
+    Database* self = static_cast<Database*>(context);
+    sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+    const char* sql = sqlite3_sql(stmt);
+
+    QueryProfile& profile = self->queryProfiles[sql ? sql : ""];
+
+    if (profile.sql.empty() && sql) profile.sql = sql;
+
+    if (type == SQLITE_TRACE_ROW) {
+        profile.rows++;
+    }
+    else if (type == SQLITE_TRACE_PROFILE) {
+        long long elapsedNs = static_cast<long long>(*static_cast<sqlite3_int64*>(x));
+
+        profile.executions++;
+        profile.totalNs += elapsedNs;
+        profile.maxNs = std::max(profile.maxNs, elapsedNs);
+
+        // Statement counters accumulate across resets, so read and reset them on every run
+        profile.fullScanSteps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+        profile.sorts += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+        profile.autoIndexes += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+        profile.vmSteps += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+    }
+
+    return 0;
+}
+
+std::vector<QueryProfile> Database::getQueryProfiles() const {
+    std::vector<QueryProfile> profiles;
+    profiles.reserve(queryProfiles.size());
+
+    for (const auto& entry : queryProfiles) profiles.push_back(entry.second);
+
+    std::sort(profiles.begin(), profiles.end(), [](const QueryProfile& a, const QueryProfile& b) {
+        return a.totalNs > b.totalNs;
+    });
+
+    return profiles;
+}
+
+std::string Database::getQueryProfileReport() const {
+    std::ostringstream ss;
+
+    ss << std::left << std::setw(8) << "Runs"
+        << std::setw(12) << "Total ms"
+        << std::setw(12) << "Max ms"
+        << std::setw(10) << "Rows"
+        << std::setw(12) << "Full scan"
+        << std::setw(8) << "Sorts"
+        << std::setw(10) << "Autoidx"
+        << "SQL\n";
+
+    for (const QueryProfile& profile : getQueryProfiles()) {
+        // Collapse whitespace so each statement fits on one line
+        std::string sql;
+        bool lastWasSpace = false;
+
+        for (char c : profile.sql) {
+            bool isSpace = std::isspace(static_cast<unsigned char>(c)) != 0;
+
+            if (!isSpace) sql += c;
+            else if (!lastWasSpace) sql += ' ';
+
+            lastWasSpace = isSpace;
+        }
+
+        ss << std::left << std::setw(8) << profile.executions
+            << std::setw(12) << std::fixed << std::setprecision(3) << (profile.totalNs / 1e6)
+            << std::setw(12) << (profile.maxNs / 1e6)
+            << std::setw(10) << profile.rows
+            << std::setw(12) << profile.fullScanSteps
+            << std::setw(8) << profile.sorts
+            << std::setw(10) << profile.autoIndexes
+            << sql << "\n";
+    }
+
+    ss << "\nLock contention: " << contentionStats.busyWaits << " busy waits, "
+        << std::fixed << std::setprecision(3) << (contentionStats.busyWaitNs / 1e6) << " ms waiting, "
+        << (contentionStats.maxBusyWaitNs / 1e6) << " ms longest wait, "
+        << contentionStats.busyTimeouts << " timeouts, "
+        << contentionStats.transactionRetries << " write retries\n";
+
+    return ss.str();
+}
+
+void Database::resetQueryProfiles() {
+    queryProfiles.clear();
+}
+
+void Database::mergeStatistics(const Database& other) {
+    for (const auto& [sql, profile] : other.queryProfiles) {
+        QueryProfile& merged = queryProfiles[sql];
+
+        merged.sql = sql;
+        merged.executions += profile.executions;
+        merged.totalNs += profile.totalNs;
+        merged.maxNs = std::max(merged.maxNs, profile.maxNs);
+        merged.rows += profile.rows;
+        merged.fullScanSteps += profile.fullScanSteps;
+        merged.sorts += profile.sorts;
+        merged.autoIndexes += profile.autoIndexes;
+        merged.vmSteps += profile.vmSteps;
+    }
+
+    contentionStats.busyWaits += other.contentionStats.busyWaits;
+    contentionStats.busyWaitNs += other.contentionStats.busyWaitNs;
+    contentionStats.maxBusyWaitNs = std::max(contentionStats.maxBusyWaitNs, other.contentionStats.maxBusyWaitNs);
+    contentionStats.busyTimeouts += other.contentionStats.busyTimeouts;
+    contentionStats.transactionRetries += other.contentionStats.transactionRetries;
+}
+
 int Database::executeQuery(const std::string& query) {
     char* errMsg = nullptr;
     int result = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &errMsg);
@@ -586,6 +2077,8 @@ int Database::executeQuery(const std::string& query) {
         std::string error = (errMsg ? errMsg : "Unknown error");
         sqlite3_free(errMsg);
 
+        if ((result == SQLITE_BUSY) || (result == SQLITE_LOCKED)) throw DatabaseBusyException("Query execution failed: " + error);
+
         throw DatabaseException("Query execution failed: " + error);
     }
 
@@ -603,8 +2096,27 @@ bool Database::tableExists(const std::string& tableName) {
     return sqlite3_step(stmt.get()) == SQLITE_ROW;
 }
 
+bool Database::columnExists(const std::string& tableName, const std::string& columnName) {
+    const std::string query = "SELECT 1 FROM pragma_table_info(?) WHERE name = ?;";
+
+    auto stmt = prepareStatement(query);
+    bindText(stmt.get(), 1, tableName);
+    bindText(stmt.get(), 2, columnName);
+
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+int Database::getPragmaInt(const std::string& pragmaName) {
+    auto stmt = prepareStatement("PRAGMA " + pragmaName + ";");
+
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) throw DatabaseException("Could not read PRAGMA " + pragmaName);
+
+    return sqlite3_column_int(stmt.get(), 0);
+}
+
 void Database::beginTransaction() {
-    executeQuery("BEGIN TRANSACTION;");
+    // Every transaction here writes, taking the write lock up front means none can deadlock upgrading a read lock
+    executeQuery("BEGIN IMMEDIATE TRANSACTION;");
 }
 
 void Database::commitTransaction() {
@@ -617,6 +2129,56 @@ void Database::rollbackTransaction() {
     }
 }
 
+void Database::loadReferenceIds() {
+    if (!isOpen()) throw DatabaseException("Database connection is not open");
+
+    categoryIds.fill(-1);
+    modeIds.fill(-1);
+
+    // Both reference tables are tiny, so read them whole and match names to enum values once
+    const std::string categoryQuery = "SELECT category_id, category_name FROM Categories;";
+    auto categoryStmt = prepareStatement(categoryQuery);
+
+    while (sqlite3_step(categoryStmt.get()) == SQLITE_ROW) {
+        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(categoryStmt.get(), 1));
+
+        for (int i = 0; i < CATEGORY_COUNT; i++) {
+            if (name == Hangman::categoryToString(static_cast<Category>(i))) categoryIds[i] = sqlite3_column_int(categoryStmt.get(), 0);
+        }
+    }
+
+    const std::string modeQuery = "SELECT mode_id, mode_name FROM Game_Modes;";
+    auto modeStmt = prepareStatement(modeQuery);
+
+    while (sqlite3_step(modeStmt.get()) == SQLITE_ROW) {
+        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(modeStmt.get(), 1));
+
+        for (int i = 0; i < MODE_COUNT; i++) {
+            if (name == Hangman::gameModeToString(static_cast<GameMode>(i))) modeIds[i] = sqlite3_column_int(modeStmt.get(), 0);
+        }
+    }
+
+    referenceIdsLoaded = true;
+}
+
+int Database::getCategoryId(Category category) {
+    int index = static_cast<int>(category);
+
+    if (!referenceIdsLoaded) loadReferenceIds();
+    if ((index < 0) || (index >= CATEGORY_COUNT) || (categoryIds[index] == -1)) throw DatabaseException("Invalid category");
+
+    return categoryIds[index];
+}
+
+int Database::getModeId(GameMode mode) {
+    int index = static_cast<int>(mode);
+
+    if (!referenceIdsLoaded) loadReferenceIds();
+    if ((index < 0) || (index >= MODE_COUNT) || (modeIds[index] == -1)) throw DatabaseException("Invalid game mode");
+
+    return modeIds[index];
+}
+
 Database::StmtPtr Database::prepareStatement(const std::string& query) {
     sqlite3_stmt* stmt = nullptr;
     int result = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
@@ -626,6 +2188,74 @@ Database::StmtPtr Database::prepareStatement(const std::string& query) {
     return StmtPtr(stmt, sqlite3_finalize);
 }
 
+int Database::busyCallback(void* context, int priorCalls) {
+    Database* database = static_cast<Database*>(context);
+    ContentionStats& stats = database->contentionStats;
+    auto now = std::chrono::steady_clock::now();
+
+    if (priorCalls == 0) database->busyWaitStart = now;
+
+    // Returning 0 makes SQLite report SQLITE_BUSY to the caller
+    if (now - database->busyWaitStart >= BUSY_TIMEOUT) {
+        stats.busyTimeouts++;
+        return 0;
+    }
+
+    std::this_thread::sleep_for(database->getBackoffDelay(priorCalls));
+
+    auto wokenAt = std::chrono::steady_clock::now();
+
+    stats.busyWaits++;
+    stats.busyWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(wokenAt - now).count();
+    stats.maxBusyWaitNs = std::max(stats.maxBusyWaitNs, static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(wokenAt - database->busyWaitStart).count()));
+
+    return 1;
+}
+
+void Database::retryOnBusy(const std::function<void()>& write) {
+    // Only for writes that leave nothing behind when they time out, such as a rolled back transaction
+    for (int attempt = 1; ; attempt++) {
+        try {
+            write();
+            return;
+        }
+        catch (const DatabaseBusyException&) {
+            if (attempt >= WRITE_ATTEMPTS) throw;
+
+            contentionStats.transactionRetries++;
+            std::this_thread::sleep_for(getBackoffDelay(attempt));
+        }
+    }
+}
+
+std::chrono::microseconds Database::getBackoffDelay(int attempt) {
+    // Doubling delays spread waiting writers out, the random half keeps them from retrying in lockstep
+    long long cap = static_cast<long long>(BUSY_MAX_DELAY.count());
+
+    if (attempt < 16) cap = std::min(cap, static_cast<long long>(BUSY_BASE_DELAY.count()) << attempt);
+
+    std::uniform_int_distribution<long long> jitter(cap / 2, cap);
+
+    return std::chrono::microseconds(jitter(backoffRandom));
+}
+
+sqlite3* Database::openSnapshotFile(const std::string& filePath, bool create) {
+    sqlite3* file = nullptr;
+    int result = sqlite3_open_v2(filePath.c_str(), &file, SQLITE_OPEN_READWRITE | (create ? SQLITE_OPEN_CREATE : 0) | SQLITE_OPEN_URI, nullptr);
+
+    if (result != SQLITE_OK) {
+        std::string error = file ? sqlite3_errmsg(file) : "Out of memory";
+
+        sqlite3_close(file);
+        throw DatabaseException("Opening " + filePath + " failed: " + error);
+    }
+
+    // Another process may be reading or writing the file
+    sqlite3_busy_timeout(file, static_cast<int>(BUSY_TIMEOUT.count()));
+
+    return file;
+}
+
 void Database::checkError(int result, const std::string& operation) {
     if (result != SQLITE_OK) throw DatabaseException(operation + " failed: " + getLastError());
 }
@@ -647,6 +2277,11 @@ void Database::bindInt(sqlite3_stmt* stmt, int index, int value) {
     checkError(result, "Binding integer parameter");
 }
 
+void Database::bindInt64(sqlite3_stmt* stmt, int index, long long value) {
+    int result = sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value));
+    checkError(result, "Binding 64-bit integer parameter");
+}
+
 void Database::bindDouble(sqlite3_stmt* stmt, int index, double value) {
     int result = sqlite3_bind_double(stmt, index, value);
     checkError(result, "Binding double parameter");
@@ -9,7 +9,10 @@ Honors Project: Hangman
 
 #include "Display.h"
 #include "Database.h"
+#include "SharedDatabase.h"
+#include "ShardedDatabase.h"
 #include "Hangman.h"
+#include "Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -41,6 +44,8 @@ std::vector<std::string> Display::rightUpperLeg;
 std::vector<std::string> Display::rightLowerLeg;
 
 void Display::initializeConsole() {
+    PROFILE_SCOPE("Display::initializeConsole");
+
     try {
         loadGameArt();
 
@@ -208,7 +213,7 @@ void Display::showGuessResult(bool correct) {
     }
 }
 
-void Display::showGameOver(const Hangman& game) {
+void Display::showGameOver(const Hangman& game, int playerRank, double percentile) {
     clearScreen();
     std::cout << generateHangmanStage(game.getIncorrectRounds()) << std::endl;
 
@@ -235,6 +240,9 @@ void Display::showGameOver(const Hangman& game) {
         resetTextColor();
     }
 
+    if (playerRank > 0) std::cout << "\nYour best score ranks #" << playerRank << " among all players\n";
+    if (percentile >= 0.0) std::cout << "This score beats " << std::setprecision(1) << percentile << "% of players' best scores\n";
+
     pauseScreen();
 }
 
@@ -344,21 +352,36 @@ void Display::showAbout() { // FIX THIS
     pauseScreen();
 }
 
-void Display::showHighScores(Database& db) {
+void Display::showHighScores(Database& db, LeaderboardWindow window) {
+    showHighScoreTables(window, [&db, window](Category category, GameMode mode) { return db.getHighScores(category, mode, window); });
+}
+
+void Display::showHighScores(SharedDatabase& db, LeaderboardWindow window) {
+    showHighScoreTables(window, [&db, window](Category category, GameMode mode) { return db.getHighScores(category, mode, window); });
+}
+
+void Display::showHighScores(ShardedDatabase& db, LeaderboardWindow window) {
+    showHighScoreTables(window, [&db, window](Category category, GameMode mode) { return db.getHighScores(category, mode, window); });
+}
+
+void Display::showHighScoreTables(LeaderboardWindow window, const std::function<std::vector<std::string>(Category, GameMode)>& getScores) {
     clearScreen();
-    std::cout << "High Scores:\n\n";
 
-    const std::vector<std::string> categories = { "CSC_111", "CSC_211", "CSC_231" };
-    const std::vector<std::string> modes = { "Classic", "Test" };
+    if (window == LeaderboardWindow::DAILY) std::cout << "Today's High Scores:\n\n";
+    else if (window == LeaderboardWindow::WEEKLY) std::cout << "This Week's High Scores:\n\n";
+    else std::cout << "High Scores:\n\n";
+
+    const std::vector<Category> categories = { Category::CSC_111, Category::CSC_211, Category::CSC_231 };
+    const std::vector<GameMode> modes = { GameMode::CLASSIC, GameMode::TEST };
 
-    for (const std::string& category : categories) {
-        std::cout << "\n" << category << ":\n";
+    for (Category category : categories) {
+        std::cout << "\n" << Hangman::categoryToString(category) << ":\n";
 
-        for (const std::string& mode : modes) {
-            std::cout << "\n" << mode << " Mode:\n";
+        for (GameMode mode : modes) {
+            std::cout << "\n" << Hangman::gameModeToString(mode) << " Mode:\n";
 
             std::vector<std::string> scores;
-            scores = db.getHighScores(category, mode);
+            scores = getScores(category, mode);
 
             if (scores.empty()) std::cout << "No scores recorded yet\n";
             else for (const std::string& score : scores) std::cout << score << "\n";
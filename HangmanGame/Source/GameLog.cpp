@@ -0,0 +1,330 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "GameLog.h"
+#include "Hangman.h"
+#include "GameEngine.h"
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+GameLog::~GameLog() {
+    try {
+        close();
+    }
+    catch (...) {
+        // Destructors must not throw, the events were already flushed to the OS
+    }
+}
+
+void GameLog::open(const std::string& path) {
+    close();
+
+    file = std::fopen(path.c_str(), "ab");
+
+    if (file == nullptr) throw GameLogException("Could not open event log: " + path);
+
+    filePath = path;
+
+    // New logs start with the header, existing logs are appended to as they are
+    std::fseek(file, 0, SEEK_END);
+
+    if (std::ftell(file) == 0) {
+        std::string header = "HGEL";
+        appendLE(header, LOG_VERSION, 4);
+
+        if ((std::fwrite(header.data(), 1, header.size(), file) != header.size()) || (std::fflush(file) != 0)) {
+            close();
+            throw GameLogException("Failed to write event log header: " + path);
+        }
+    }
+
+    eventsSinceSync = 0;
+    lastSyncTime = std::chrono::steady_clock::now();
+}
+
+void GameLog::close() {
+    if (file != nullptr) {
+        sync();
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    filePath.clear();
+    currentGameId = 0;
+}
+
+void GameLog::sync() {
+    if (file == nullptr) return;
+
+    std::fflush(file);
+
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+
+    eventsSinceSync = 0;
+    lastSyncTime = std::chrono::steady_clock::now();
+}
+
+void GameLog::appendStartGame(int playerId, Category category, GameMode mode, const std::vector<int>& questionIds) {
+    // Random IDs keep games apart when several processes append to the same log
+    std::random_device rd;
+    currentGameId = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+
+    std::string payload;
+    appendLE(payload, static_cast<std::uint32_t>(playerId), 4);
+    appendLE(payload, static_cast<std::uint8_t>(category), 1);
+    appendLE(payload, static_cast<std::uint8_t>(mode), 1);
+    appendLE(payload, questionIds.size(), 2);
+
+    for (int id : questionIds) appendLE(payload, static_cast<std::uint32_t>(id), 4);
+
+    appendLE(payload, SCORE_SAVED_FLAG, 1);
+
+    appendEvent(GameEventType::START_GAME, payload, false);
+}
+
+void GameLog::appendGuess(const std::string& guess, bool correct) {
+    if (guess.size() > 0xFFFF) throw GameLogException("Guess is too long to log");
+
+    std::string payload;
+    appendLE(payload, correct ? 1 : 0, 1);
+    appendLE(payload, guess.size(), 2);
+    payload += guess;
+
+    appendEvent(GameEventType::GUESS, payload, false);
+}
+
+void GameLog::appendEndGame(int scoreCenti) {
+    std::string payload;
+    appendLE(payload, static_cast<std::uint32_t>(scoreCenti), 4);
+
+    appendEvent(GameEventType::END_GAME, payload, true);
+}
+
+void GameLog::appendResetGame() {
+    appendEvent(GameEventType::RESET_GAME, "", true);
+}
+
+void GameLog::appendScoreSaved() {
+    appendEvent(GameEventType::SCORE_SAVED, "", true);
+}
+
+void GameLog::appendEndGame(std::uint64_t gameId, int scoreCenti) {
+    currentGameId = gameId;
+    appendEndGame(scoreCenti);
+    currentGameId = 0;
+}
+
+void GameLog::appendScoreSaved(std::uint64_t gameId) {
+    currentGameId = gameId;
+    appendScoreSaved();
+    currentGameId = 0;
+}
+
+void GameLog::appendEvent(GameEventType type, const std::string& payload, bool forceSync) {
+    if (file == nullptr) throw GameLogException("Event log is not open");
+
+    long long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::string event;
+    event.reserve(25 + payload.size());
+
+    appendLE(event, static_cast<std::uint8_t>(type), 1);
+    appendLE(event, payload.size(), 4);
+    appendLE(event, currentGameId, 8);
+    appendLE(event, static_cast<std::uint64_t>(now), 8);
+    event += payload;
+    appendLE(event, fnv1a(reinterpret_cast<const unsigned char*>(event.data()), event.size()), 4);
+
+    // One write per event, flushed so a crashed process loses nothing the OS has seen
+    if ((std::fwrite(event.data(), 1, event.size(), file) != event.size()) || (std::fflush(file) != 0)) throw GameLogException("Failed to append to event log: " + filePath);
+
+    eventsSinceSync++;
+
+    bool isSyncDue = forceSync || (eventsSinceSync >= SYNC_EVENT_INTERVAL) || ((std::chrono::steady_clock::now() - lastSyncTime) >= SYNC_INTERVAL);
+
+    if (isSyncDue) sync();
+}
+
+std::vector<LoggedGame> GameLog::readGames(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+
+    if (!input) throw GameLogException("Could not open event log: " + path);
+
+    const std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bytes.data());
+
+    if ((bytes.size() < 8) || (std::memcmp(data, "HGEL", 4) != 0)) throw GameLogException("Not an event log: " + path);
+    if (readLE(data + 4, 4) != LOG_VERSION) throw GameLogException("Unsupported event log version: " + path);
+
+    std::vector<LoggedGame> games;
+    std::unordered_map<std::uint64_t, std::size_t> gameIndex;  // Game ID to position in games
+    std::size_t pos = 8;
+
+    while (bytes.size() - pos >= 25) {
+        const unsigned char* event = data + pos;
+        std::size_t payloadLength = static_cast<std::size_t>(readLE(event + 1, 4));
+
+        if (bytes.size() - pos - 25 < payloadLength) break;  // Torn write at the tail
+
+        std::size_t eventLength = 21 + payloadLength;
+
+        if (readLE(event + eventLength, 4) != fnv1a(event, eventLength)) break;
+
+        GameEventType type = static_cast<GameEventType>(event[0]);
+        std::uint64_t gameId = readLE(event + 5, 8);
+        const unsigned char* payload = event + 21;
+
+        pos += eventLength + 4;
+
+        if (type == GameEventType::START_GAME) {
+            if (payloadLength < 8) continue;
+
+            LoggedGame game;
+            game.gameId = gameId;
+            game.startedAt = static_cast<long long>(readLE(event + 13, 8));
+            game.playerId = static_cast<std::int32_t>(readLE(payload, 4));
+            game.category = static_cast<Category>(payload[4]);
+            game.mode = static_cast<GameMode>(payload[5]);
+
+            std::size_t count = static_cast<std::size_t>(readLE(payload + 6, 2));
+
+            if (payloadLength < 8 + (count * 4)) continue;
+
+            for (std::size_t i = 0; i < count; i++) game.questionIds.push_back(static_cast<std::int32_t>(readLE(payload + 8 + (i * 4), 4)));
+
+            if (payloadLength > 8 + (count * 4)) game.tracksScoreSaved = (payload[8 + (count * 4)] & SCORE_SAVED_FLAG) != 0;
+
+            gameIndex[gameId] = games.size();
+            games.push_back(std::move(game));
+            continue;
+        }
+
+        // Everything else belongs to a game started earlier in the log
+        auto found = gameIndex.find(gameId);
+
+        if (found == gameIndex.end()) continue;
+
+        LoggedGame& game = games[found->second];
+
+        if ((type == GameEventType::GUESS) && (payloadLength >= 3)) {
+            std::size_t length = static_cast<std::size_t>(readLE(payload + 1, 2));
+
+            if (payloadLength >= 3 + length) game.guesses.emplace_back(reinterpret_cast<const char*>(payload + 3), length);
+        }
+        else if ((type == GameEventType::END_GAME) && (payloadLength >= 4)) {
+            game.isFinished = true;
+            game.loggedScoreCenti = static_cast<int>(readLE(payload, 4));
+
+            // Before SCORE_SAVED existed a finished game had its score saved, recovery leaves those alone
+            if (!game.tracksScoreSaved) game.isScoreSaved = true;
+        }
+        else if (type == GameEventType::SCORE_SAVED) {
+            game.isScoreSaved = true;
+        }
+        else if (type == GameEventType::RESET_GAME) {
+            game.isAbandoned = true;
+        }
+    }
+
+    return games;
+}
+
+void GameLog::replayGame(const LoggedGame& game, Hangman& hangman) {
+    if (hangman.getEventLog() != nullptr) throw GameLogException("Cannot replay into a game that is logging events");
+
+    hangman.resetGame();
+    hangman.setGameMode(game.mode);
+    hangman.setCategory(game.category);
+    hangman.setCurrentPlayerId(game.playerId);
+    hangman.startGameWithQuestions(game.questionIds);
+
+    // Guesses are judged again, so rule changes since the game was played show up in the score
+    std::size_t nextGuess = 0;
+
+    GameEngine<Hangman>(hangman).run([&]() -> const std::string* {
+        return (nextGuess < game.guesses.size()) ? &game.guesses[nextGuess++] : nullptr;
+    });
+
+    if (game.isFinished) hangman.endGame();
+}
+
+std::vector<ReplayResult> GameLog::replayScores(const std::string& path, const std::map<Category, std::vector<QuestionAnswer>>& banks, Hangman& hangman) {
+    std::vector<LoggedGame> games = readGames(path);
+    std::vector<ReplayResult> results;
+    results.reserve(games.size());
+
+    // The caller's game carries the rules to score with, such as answer matching settings
+    const std::vector<QuestionAnswer>* loadedBank = nullptr;
+
+    for (LoggedGame& game : games) {
+        ReplayResult result;
+
+        try {
+            auto bank = banks.find(game.category);
+
+            if (bank == banks.end()) throw GameLogException("No questions for category " + Hangman::categoryToString(game.category));
+
+            // Banks are only reloaded when the category changes between games
+            if (loadedBank != &bank->second) {
+                hangman.resetGame();
+                hangman.loadQuestions(bank->second);
+                loadedBank = &bank->second;
+            }
+
+            replayGame(game, hangman);
+            result.replayedScoreCenti = hangman.getCurrentScoreCenti();
+        }
+        catch (const std::exception& err) {
+            result.error = err.what();
+        }
+
+        result.game = std::move(game);
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
+
+void GameLog::appendLE(std::string& out, std::uint64_t value, int byteCount) {
+    for (int i = 0; i < byteCount; i++) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+std::uint64_t GameLog::readLE(const unsigned char* bytes, int byteCount) {
+    std::uint64_t value = 0;
+
+    for (int i = 0; i < byteCount; i++) value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+
+    return value;
+}
+
+std::uint32_t GameLog::fnv1a(const unsigned char* bytes, std::size_t count) {
+    std::uint32_t hash = 2166136261u;
+
+    for (std::size_t i = 0; i < count; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// GAME_LOG_CPP
@@ -0,0 +1,55 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "GameRegistry.h"
+#include "Hangman.h"
+
+void GameRegistry::registerGame(const std::string& name, GameFactory factory) {
+    if (name.empty()) throw GameException("Game name cannot be empty");
+    if (!factory) throw GameException("Game factory cannot be empty: " + name);
+
+    bool inserted = getFactories().emplace(name, std::move(factory)).second;
+
+    if (!inserted) throw GameException("Game is already registered: " + name);
+}
+
+std::unique_ptr<QuizGame> GameRegistry::create(const std::string& name) {
+    auto found = getFactories().find(name);
+
+    if (found == getFactories().end()) throw GameException("Unknown game: " + name);
+
+    std::unique_ptr<QuizGame> game = found->second();
+
+    if (game == nullptr) throw GameException("Game factory returned nothing: " + name);
+
+    return game;
+}
+
+bool GameRegistry::isRegistered(const std::string& name) {
+    return getFactories().count(name) > 0;
+}
+
+std::vector<std::string> GameRegistry::getGameNames() {
+    std::vector<std::string> names;
+
+    for (const auto& entry : getFactories()) names.push_back(entry.first);
+
+    return names;
+}
+
+std::map<std::string, GameFactory>& GameRegistry::getFactories() {
+    // Function-local so registration never depends on static initialization order
+    static std::map<std::string, GameFactory> factories = {
+        { "Hangman", [] { return std::make_unique<Hangman>(); } }
+    };
+
+    return factories;
+}
+
+// GAME_REGISTRY_CPP
@@ -8,39 +8,57 @@ Honors Project: Hangman
 */
 
 #include "Hangman.h"
+#include "Profiler.h"
+#include "TextMatch.h"
+#include "GameLog.h"
+#include "QuestionBank.h"
 #include <iostream>
 #include <stdexcept>
 #include <random>
 #include <algorithm>
-#include <cctype>
+#include <cmath>
 
-Hangman::Hangman() : Game("Hangman", true, true) {
+Hangman::Hangman() : QuizGame("Hangman", true, true) {
     currentState = GameState::MENU;
     currentMode = GameMode::CLASSIC;
     currentCategory = Category::CSC_111;
     currentDbPath = "";
     currentRound = 0;
-    currentScore = 0.00;
+    currentScore = 0;
     incorrectRounds = 0;
     incorrectGuesses = 0;
     remainingChances = MAX_CLASSIC_QUESTION_CHANCES;
     timeLimit = std::chrono::seconds(SECONDS_PER_TEST_QUESTION * TOTAL_ROUNDS);
     currentPlayerId = -1;
     hasPlayerWon = false;
+    roundGuesses = 0;
+    selectionPolicy = SelectionPolicy::ADAPTIVE;
+    playerSkill = DEFAULT_PLAYER_SKILL;
+    eventLog = nullptr;
 }
 
 bool Hangman::startGame() {
     try {
-        if (fullQuestionBank.empty()) throw HangmanException("Question bank is empty");
+        if (getPoolSize() == 0) throw HangmanException("Question bank is empty");
 
         initializeGame();
         selectRandomQuestions();
+        beginRounds();
+    }
+    catch (const std::exception& err) {
+        throw HangmanException("Failed to start game: " + std::string(err.what()));
+    }
 
-        currentState = GameState::PLAYING;
+    return isGameActive;
+}
 
-        if (currentMode == GameMode::TEST) gameStartTime = std::chrono::steady_clock::now();
+bool Hangman::startGameWithQuestions(const std::vector<int>& questionIds) {
+    try {
+        if (getPoolSize() == 0) throw HangmanException("Question bank is empty");
 
-        isGameActive = true;
+        initializeGame();
+        selectQuestionsById(questionIds);
+        beginRounds();
     }
     catch (const std::exception& err) {
         throw HangmanException("Failed to start game: " + std::string(err.what()));
@@ -49,47 +67,144 @@ bool Hangman::startGame() {
     return isGameActive;
 }
 
+void Hangman::beginRounds() {
+    if (eventLog != nullptr) eventLog->appendStartGame(currentPlayerId, currentCategory, currentMode, getQuestionIds());
+
+    currentState = GameState::PLAYING;
+
+    if (currentMode == GameMode::TEST) gameStartTime = std::chrono::steady_clock::now();
+
+    roundStartTime = std::chrono::steady_clock::now();
+
+    isGameActive = true;
+}
+
 void Hangman::initializeGame() {
     currentState = GameState::MENU;
     currentRound = 1;
-    currentScore = 0.00;
+    currentScore = 0;
     incorrectRounds = 0;
     incorrectGuesses = 0;
     remainingChances = MAX_CLASSIC_QUESTION_CHANCES;
+    roundGuesses = 0;
 
     questionSet.clear();
 }
 
 void Hangman::selectRandomQuestions() {
-    if (fullQuestionBank.size() < TOTAL_ROUNDS) throw HangmanException("Insufficient number of questions in question bank");
+    if (getPoolSize() < TOTAL_ROUNDS) throw HangmanException("Insufficient number of questions in question bank");
 
-    // Reset "used" flag for all questions
-    for (QuestionAnswer& qa : fullQuestionBank) qa.used = false;
+    // Nothing is drawn yet
+    drawnIndices.clear();
 
     // Create random number generator
     std::random_device rd;
     std::mt19937 gen(rd());
 
+    questionSet.clear();
+
+    // Adaptive draws favour questions near the player's skill, each draw is O(1) regardless of bank size
+    if (selectionPolicy == SelectionPolicy::ADAPTIVE) {
+        const AliasSampler& sampler = getDifficultySampler();
+        int attempts = 0;
+
+        while ((questionSet.size() < TOTAL_ROUNDS) && (attempts < MAX_SAMPLING_ATTEMPTS)) {
+            std::size_t index = sampler.sample(gen);
+            attempts++;
+
+            if (!isDrawn(index)) drawQuestion(index);
+        }
+    }
+
     int values = 0;
-    values = static_cast<int>(fullQuestionBank.size() - 1);
+    values = static_cast<int>(getPoolSize() - 1);
 
     std::uniform_int_distribution<int> dis(0, values);
-    questionSet.clear();
 
-    // Put questions into the current question set
+    // Put questions into the current question set (tops up the adaptive set if it ran out of attempts)
     while (questionSet.size() < TOTAL_ROUNDS) {
         int index = 0;
         index = dis(gen);
 
-        if (!fullQuestionBank[index].used) {
-            questionSet.push_back(fullQuestionBank[index]);
-            fullQuestionBank[index].used = true;
-        }
+        if (!isDrawn(index)) drawQuestion(index);
     }
 
     if (questionSet.size() != TOTAL_ROUNDS) throw HangmanException("Cannot load random questions into question set");
 }
 
+void Hangman::selectQuestionsById(const std::vector<int>& questionIds) {
+    if (questionIds.size() != TOTAL_ROUNDS) throw HangmanException("A game needs exactly " + std::to_string(TOTAL_ROUNDS) + " questions");
+
+    drawnIndices.clear();
+    questionSet.clear();
+
+    // A linear search per ID, replays are the only caller
+    for (int id : questionIds) {
+        std::size_t index = 0;
+
+        while ((index < getPoolSize()) && (getPoolId(index) != id)) index++;
+
+        if (index == getPoolSize()) throw HangmanException("Question " + std::to_string(id) + " is not in the question bank");
+
+        drawQuestion(index);
+    }
+}
+
+void Hangman::drawQuestion(std::size_t index) {
+    if (mappedBank) questionSet.push_back(mappedBank->getQuestionAnswer(index));
+    else questionSet.push_back(loadedQuestions[index]);
+
+    drawnIndices.push_back(index);
+}
+
+bool Hangman::isDrawn(std::size_t index) const {
+    return std::find(drawnIndices.begin(), drawnIndices.end(), index) != drawnIndices.end();
+}
+
+std::size_t Hangman::getPoolSize() const {
+    return mappedBank ? mappedBank->size() : loadedQuestions.size();
+}
+
+int Hangman::getPoolId(std::size_t index) const {
+    return mappedBank ? mappedBank->getQuestionId(index) : loadedQuestions[index].id;
+}
+
+double Hangman::getPoolDifficulty(std::size_t index) const {
+    return mappedBank ? mappedBank->getDifficulty(index) : loadedQuestions[index].difficulty;
+}
+
+std::vector<int> Hangman::getQuestionIds() const {
+    std::vector<int> ids;
+    ids.reserve(questionSet.size());
+
+    for (const QuestionAnswer& qa : questionSet) ids.push_back(qa.id);
+
+    return ids;
+}
+
+const AliasSampler& Hangman::getDifficultySampler() {
+    int level = static_cast<int>(std::lround(playerSkill * (SKILL_LEVELS - 1)));
+    level = std::min(std::max(level, 0), SKILL_LEVELS - 1);
+
+    AliasSampler& sampler = difficultySamplers[level];
+
+    if (sampler.isEmpty()) {
+        // Weight each question by how close its difficulty is to this level's target difficulty
+        double target = static_cast<double>(level) / (SKILL_LEVELS - 1);
+        std::vector<double> weights;
+        weights.reserve(getPoolSize());
+
+        for (std::size_t i = 0; i < getPoolSize(); i++) {
+            double distance = getPoolDifficulty(i) - target;
+            weights.push_back(MIN_QUESTION_WEIGHT + std::exp(-(distance * distance) / (2.0 * DIFFICULTY_SPREAD * DIFFICULTY_SPREAD)));
+        }
+
+        sampler = AliasSampler(weights);
+    }
+
+    return sampler;
+}
+
 bool Hangman::isGameOver() const {
     bool gameOverFlag = false;
 
@@ -102,24 +217,40 @@ bool Hangman::isGameOver() const {
 }
 
 void Hangman::endGame() {
+    bool wasActive = isGameActive;
+
+    // Fold the finished game into the running skill estimate used by adaptive selection
+    if (wasActive) playerSkill = ((1.0 - SKILL_SMOOTHING) * playerSkill) + (SKILL_SMOOTHING * (static_cast<double>(currentScore) / MAX_SCORE));
+
     currentState = GameState::GAME_OVER;
     isGameActive = false;
+
+    if (wasActive && (eventLog != nullptr)) eventLog->appendEndGame(currentScore);
 }
 
 void Hangman::resetGame() {
+    bool wasActive = isGameActive;
+
     isGameActive = false;
     currentState = GameState::MENU;
     currentRound = 0;
-    currentScore = 0.00;
+    currentScore = 0;
     incorrectRounds = 0;
     incorrectGuesses = 0;
     remainingChances = MAX_CLASSIC_QUESTION_CHANCES;
     hasPlayerWon = false;
+    roundGuesses = 0;
 
+    // Quitting discards the rounds played so far, like the score
+    pendingQuestionStats.clear();
     questionSet.clear();
+
+    if (wasActive && (eventLog != nullptr)) eventLog->appendResetGame();
 }
 
 bool Hangman::makeGuess(const std::string& guess) {
+    PROFILE_SCOPE("Hangman::makeGuess");
+
     if (!validateGuess(guess)) throw HangmanException("Invalid guess format");
     if (currentRound > TOTAL_ROUNDS) throw HangmanException("Cannot make guess: Game is over");
     if (currentState != GameState::PLAYING) throw HangmanException("Cannot make guess: Game is not in playing state");
@@ -127,15 +258,13 @@ bool Hangman::makeGuess(const std::string& guess) {
 
     const QuestionAnswer& currentQA = getCurrentQuestion();
 
-    // Case-insensitive comparison
-    std::string guessLower = guess;
-    std::string answerLower = currentQA.answer;
+    bool isCorrect = false;
+    isCorrect = isAnswerMatch(guess, currentQA);
 
-    std::transform(guessLower.begin(), guessLower.end(), guessLower.begin(), ::tolower);
-    std::transform(answerLower.begin(), answerLower.end(), answerLower.begin(), ::tolower);
+    // Logged before any state changes, so a failed write leaves the game where it was
+    if (eventLog != nullptr) eventLog->appendGuess(guess, isCorrect);
 
-    bool isCorrect = false;
-    isCorrect = (guessLower == answerLower);
+    roundGuesses++;
 
     // Update score
     updateScore(isCorrect);
@@ -147,6 +276,7 @@ bool Hangman::makeGuess(const std::string& guess) {
         }
 
         if ((incorrectGuesses >= 5) || isCorrect) {
+            recordRoundResult(currentQA, isCorrect);
             currentRound++;
             incorrectGuesses = 0;
             remainingChances = MAX_CLASSIC_QUESTION_CHANCES;
@@ -154,6 +284,7 @@ bool Hangman::makeGuess(const std::string& guess) {
     }
     else {  // Test mode
         if (!isCorrect) incorrectRounds++;
+        recordRoundResult(currentQA, isCorrect);
         currentRound++;
     }
 
@@ -162,14 +293,71 @@ bool Hangman::makeGuess(const std::string& guess) {
     return isCorrect;
 }
 
+void Hangman::recordRoundResult(const QuestionAnswer& qa, bool correct) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (qa.id != -1) {
+        QuestionStat& stat = pendingQuestionStats[qa.id];
+
+        stat.questionId = qa.id;
+        stat.timesAsked++;
+        stat.timesCorrect += (correct ? 1 : 0);
+        stat.totalGuesses += roundGuesses;
+        stat.totalAnswerMs += std::chrono::duration_cast<std::chrono::milliseconds>(now - roundStartTime).count();
+    }
+
+    roundGuesses = 0;
+    roundStartTime = now;
+}
+
+std::vector<QuestionStat> Hangman::takeQuestionStats() {
+    std::vector<QuestionStat> stats;
+    stats.reserve(pendingQuestionStats.size());
+
+    for (const auto& entry : pendingQuestionStats) stats.push_back(entry.second);
+
+    pendingQuestionStats.clear();
+
+    return stats;
+}
+
 bool Hangman::validateGuess(const std::string& guess) const {
     bool isValid = false;
 
-    if (!guess.empty() && (guess.size() <= 200)) isValid = true;  // Integer 200 used as an arbitrary max length
+    if (!guess.empty() && (guess.size() <= MAX_GUESS_LENGTH)) isValid = true;
     
     return isValid;
 }
 
+bool Hangman::isAnswerMatch(const std::string& guess, const QuestionAnswer& qa) const {
+    // Case-insensitive comparison against every accepted answer
+    if (qa.matcher.matches(guess)) return true;
+
+    const AnswerMatchSettings& settings = getAnswerMatching(currentMode);
+
+    if (!settings.allowTypos) return false;
+
+    // Normalize into a stack buffer so fuzzy matching stays allocation-free
+    std::array<char, MAX_GUESS_LENGTH * 2> normalizedGuess;
+    std::size_t length = TextMatch::normalize(guess, normalizedGuess.data(), normalizedGuess.size());
+    std::string_view guessView(normalizedGuess.data(), length);
+
+    for (const std::string& normalizedAnswer : qa.matcher.getNormalizedAnswers()) {
+        int budget = getTypoBudget(normalizedAnswer);
+
+        if (TextMatch::boundedEditDistance(guessView, normalizedAnswer, budget) <= budget) return true;
+    }
+
+    return false;
+}
+
+int Hangman::getTypoBudget(const std::string& normalizedAnswer) const {
+    // Short answers like "int" or "new" must be exact, longer ones tolerate a typo per ANSWER_CHARS_PER_TYPO characters
+    int lengthBudget = static_cast<int>(normalizedAnswer.size() / ANSWER_CHARS_PER_TYPO);
+
+    return std::min(lengthBudget, getAnswerMatching(currentMode).maxTypos);
+}
+
 void Hangman::updateScore(bool isCorrect) {
     if (currentMode == GameMode::CLASSIC) {  // Classic mode
         if (isCorrect) {
@@ -185,7 +373,7 @@ void Hangman::updateScore(bool isCorrect) {
     }
 
     // Ensure score does not exceed MAX_SCORE or go below 0
-    currentScore = std::min(std::max(currentScore, 0.00), MAX_SCORE);
+    currentScore = std::min(std::max(currentScore, 0), MAX_SCORE);
 }
 
 bool Hangman::isTimeExpired() const {
@@ -209,6 +397,25 @@ void Hangman::setGameMode(GameMode mode) {
     currentMode = mode;
 }
 
+void Hangman::setPlayerSkill(double skill) {
+    if ((skill < 0.0) || (skill > 1.0)) throw HangmanException("Player skill must be between 0 and 1");
+    playerSkill = skill;
+}
+
+void Hangman::resetPlayer() {
+    currentPlayerId = -1;
+    playerSkill = DEFAULT_PLAYER_SKILL;
+}
+
+void Hangman::setAnswerMatching(GameMode mode, const AnswerMatchSettings& settings) {
+    if ((settings.maxTypos < 0) || (settings.maxTypos > TextMatch::MAX_EDIT_DISTANCE)) throw HangmanException("Invalid typo limit");
+    answerMatching[static_cast<int>(mode)] = settings;
+}
+
+const AnswerMatchSettings& Hangman::getAnswerMatching(GameMode mode) const {
+    return answerMatching[static_cast<int>(mode)];
+}
+
 void Hangman::setCategory(Category cat) {
     if (currentState == GameState::PLAYING) throw HangmanException("Cannot change category while playing");
     currentCategory = cat;
@@ -216,7 +423,29 @@ void Hangman::setCategory(Category cat) {
 
 bool Hangman::loadQuestions(const std::vector<QuestionAnswer>& questions) {
     if (questions.empty()) throw HangmanException("Cannot load empty question set");
-    fullQuestionBank = questions;
+
+    loadedQuestions = questions;
+    mappedBank.reset();
+    drawnIndices.clear();
+
+    // Sampling tables describe the previous bank
+    for (AliasSampler& sampler : difficultySamplers) sampler = AliasSampler();
+
+    return true;
+}
+
+bool Hangman::loadQuestions(std::shared_ptr<const QuestionBank> bank) {
+    if (!bank || !bank->isOpen() || (bank->size() == 0)) throw HangmanException("Cannot load empty question set");
+
+    // Nothing is read from the bank here, so a load costs the same for any bank size.
+    // Sampling tables are only rebuilt for a different bank, the same one keeps its difficulties.
+    if (bank != mappedBank) {
+        for (AliasSampler& sampler : difficultySamplers) sampler = AliasSampler();
+    }
+
+    loadedQuestions.clear();
+    mappedBank = std::move(bank);
+    drawnIndices.clear();
 
     return true;
 }
@@ -272,10 +501,10 @@ bool Hangman::isNewHighScore() const {
         Database db;
         db.open(currentDbPath);
 
-        double highScore = db.getHighScore(currentPlayerId, categoryToString(currentCategory), gameModeToString(currentMode));
+        int highScoreCenti = db.getHighScoreCenti(currentPlayerId, currentCategory, currentMode);
 
         db.close();
-        isNew = currentScore > highScore;
+        isNew = currentScore > highScoreCenti;
     }
     catch (const DatabaseException& err) {
         throw HangmanException("Cannot check for new high score: " + std::string(err.what()));
@@ -0,0 +1,154 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "Profiler.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+
+// Initialize static members
+std::atomic<bool> Profiler::enabled(false);
+std::atomic<std::uint64_t> Profiler::nextSlot(0);
+std::array<ProfileSample, Profiler::RING_CAPACITY> Profiler::ring;
+std::chrono::steady_clock::time_point Profiler::epoch = std::chrono::steady_clock::now();
+ProfileFormat Profiler::outputFormat = ProfileFormat::JSON;
+std::string Profiler::outputPath = "";
+
+void Profiler::enable(ProfileFormat format, const std::string& path) {
+    outputFormat = format;
+    outputPath = path;
+    epoch = std::chrono::steady_clock::now();
+    nextSlot.store(0, std::memory_order_relaxed);
+
+    enabled.store(true, std::memory_order_release);
+}
+
+void Profiler::disable() {
+    enabled.store(false, std::memory_order_release);
+}
+
+void Profiler::record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    if (!isEnabled()) return;
+
+    // Claim a slot atomically so background threads can record alongside the game thread
+    std::uint64_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+    ProfileSample& sample = ring[slot % RING_CAPACITY];
+
+    sample.name = name;
+    sample.startNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count());
+    sample.durationNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    sample.threadId = currentThreadId();
+}
+
+std::uint32_t Profiler::currentThreadId() {
+    static std::atomic<std::uint32_t> nextThreadId(1);
+    thread_local std::uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+
+    return threadId;
+}
+
+std::size_t Profiler::collectSamples(std::array<ProfileSample, RING_CAPACITY>& samples) {
+    std::uint64_t total = nextSlot.load(std::memory_order_acquire);
+    std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(total, RING_CAPACITY));
+    std::uint64_t first = total - count;
+
+    // Copy out oldest first
+    for (std::size_t i = 0; i < count; i++) samples[i] = ring[(first + i) % RING_CAPACITY];
+
+    return count;
+}
+
+std::string Profiler::toJSON() {
+    struct PhaseSummary {
+        std::uint64_t count = 0;
+        std::uint64_t totalNs = 0;
+        std::uint64_t maxNs = 0;
+    };
+
+    static std::array<ProfileSample, RING_CAPACITY> samples;
+    std::size_t count = collectSamples(samples);
+    std::map<std::string, PhaseSummary> summaries;
+    std::ostringstream ss;
+
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\n  \"samples\": [";
+
+    for (std::size_t i = 0; i < count; i++) {
+        const ProfileSample& sample = samples[i];
+        PhaseSummary& summary = summaries[sample.name];
+
+        summary.count++;
+        summary.totalNs += sample.durationNs;
+        summary.maxNs = std::max(summary.maxNs, sample.durationNs);
+
+        ss << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << sample.name << "\", "
+            << "\"start_us\": " << (sample.startNs / 1000.0) << ", "
+            << "\"duration_us\": " << (sample.durationNs / 1000.0) << ", "
+            << "\"thread\": " << sample.threadId << "}";
+    }
+
+    ss << "\n  ],\n  \"summary\": {";
+
+    bool isFirst = true;
+    for (const auto& [name, summary] : summaries) {
+        ss << (isFirst ? "\n" : ",\n")
+            << "    \"" << name << "\": {"
+            << "\"count\": " << summary.count << ", "
+            << "\"total_us\": " << (summary.totalNs / 1000.0) << ", "
+            << "\"mean_us\": " << (summary.totalNs / 1000.0 / summary.count) << ", "
+            << "\"max_us\": " << (summary.maxNs / 1000.0) << "}";
+
+        isFirst = false;
+    }
+
+    ss << "\n  },\n  \"dropped\": " << (nextSlot.load() - count) << "\n}\n";
+
+    return ss.str();
+}
+
+std::string Profiler::toChromeTrace() {
+    static std::array<ProfileSample, RING_CAPACITY> samples;
+    std::size_t count = collectSamples(samples);
+    std::ostringstream ss;
+
+    // Complete ("X") events, viewable in chrome://tracing or Perfetto
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"traceEvents\": [";
+
+    for (std::size_t i = 0; i < count; i++) {
+        const ProfileSample& sample = samples[i];
+
+        ss << (i == 0 ? "\n" : ",\n")
+            << "  {\"name\": \"" << sample.name << "\", \"cat\": \"hangman\", \"ph\": \"X\", "
+            << "\"ts\": " << (sample.startNs / 1000.0) << ", "
+            << "\"dur\": " << (sample.durationNs / 1000.0) << ", "
+            << "\"pid\": 1, \"tid\": " << sample.threadId << "}";
+    }
+
+    ss << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+    return ss.str();
+}
+
+void Profiler::dump() {
+    if (outputPath.empty()) return;
+
+    std::ofstream file(outputPath);
+
+    if (!file) throw std::runtime_error("Could not open profile output file: " + outputPath);
+
+    file << ((outputFormat == ProfileFormat::CHROME_TRACE) ? toChromeTrace() : toJSON());
+    file.close();
+}
+
+// PROFILER_CPP
@@ -0,0 +1,327 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "QuestionBank.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+QuestionBank::~QuestionBank() {
+    close();
+}
+
+QuestionBank::QuestionBank(QuestionBank&& other) noexcept {
+    *this = std::move(other);
+}
+
+QuestionBank& QuestionBank::operator=(QuestionBank&& other) noexcept {
+    if (this != &other) {
+        close();
+
+        data = std::exchange(other.data, nullptr);
+        length = std::exchange(other.length, 0);
+        questionCount = std::exchange(other.questionCount, 0);
+        records = std::exchange(other.records, nullptr);
+        blob = std::exchange(other.blob, nullptr);
+        blobSize = std::exchange(other.blobSize, 0);
+    }
+
+    return *this;
+}
+
+void QuestionBank::compile(const std::vector<QuestionAnswer>& questions, const std::string& path, long long timesAsked) {
+    std::string recordBytes;
+    std::string blobBytes;
+
+    recordBytes.reserve(questions.size() * RECORD_SIZE);
+
+    for (const QuestionAnswer& qa : questions) {
+        std::string alternates;
+
+        for (const std::string& alternate : qa.alternateAnswers) {
+            if (!alternates.empty()) alternates += '\t';
+            alternates += alternate;
+        }
+
+        double difficulty = std::min(std::max(qa.difficulty, 0.0), 1.0);
+
+        appendLE(recordBytes, static_cast<std::uint32_t>(qa.id), 4);
+        appendLE(recordBytes, static_cast<std::uint32_t>(std::lround(difficulty * DIFFICULTY_SCALE)), 4);
+
+        for (const std::string* text : { &qa.question, &qa.answer, static_cast<const std::string*>(&alternates) }) {
+            if (blobBytes.size() + text->size() > std::numeric_limits<std::uint32_t>::max()) throw QuestionBankException("Question bank exceeds 4 GiB: " + path);
+
+            appendLE(recordBytes, blobBytes.size(), 4);
+            appendLE(recordBytes, text->size(), 4);
+            blobBytes += *text;
+        }
+    }
+
+    std::uint32_t checksum = fnv1a(reinterpret_cast<const unsigned char*>(recordBytes.data()), recordBytes.size());
+    checksum = fnv1a(reinterpret_cast<const unsigned char*>(blobBytes.data()), blobBytes.size(), checksum);
+
+    std::string header = "HGQB";
+    appendLE(header, BANK_VERSION, 4);
+    appendLE(header, questions.size(), 4);
+    appendLE(header, static_cast<std::uint64_t>(timesAsked), 4);
+    appendLE(header, blobBytes.size(), 8);
+    appendLE(header, checksum, 4);
+    appendLE(header, 0, 4);
+
+    // Write beside the target and rename, so readers never map a half-written bank
+    const std::string tempPath = path + ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+        if (!file) throw QuestionBankException("Could not create question bank: " + tempPath);
+
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(recordBytes.data(), static_cast<std::streamsize>(recordBytes.size()));
+        file.write(blobBytes.data(), static_cast<std::streamsize>(blobBytes.size()));
+        file.close();
+
+        if (!file) throw QuestionBankException("Failed to write question bank: " + tempPath);
+    }
+
+    // Replaces the old bank in one step, there is never a moment without one
+    std::error_code renameError;
+    std::filesystem::rename(tempPath, path, renameError);
+
+    if (renameError) throw QuestionBankException("Failed to replace question bank: " + path);
+}
+
+void QuestionBank::compileFromTSV(const std::string& tsvPath, const std::string& path) {
+    std::ifstream file(tsvPath);
+
+    if (!file.is_open()) throw QuestionBankException("Unable to open TSV file: " + tsvPath);
+
+    std::vector<QuestionAnswer> questions;
+
+    // Same line format as Database::loadQuestionsFromTSV: question, answer, then alternate answers
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t tabPos = 0;
+
+        while ((tabPos = line.find('\t', start)) != std::string::npos) {
+            fields.push_back(line.substr(start, tabPos - start));
+            start = tabPos + 1;
+        }
+
+        fields.push_back(line.substr(start));
+
+        if (fields.size() < 2) continue;  // Skip malformed lines
+
+        std::vector<std::string> alternates;
+
+        for (size_t i = 2; i < fields.size(); i++) {
+            if (!fields[i].empty()) alternates.push_back(fields[i]);
+        }
+
+        questions.emplace_back(fields[0], fields[1], alternates);
+    }
+
+    compile(questions, path);
+}
+
+void QuestionBank::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) throw QuestionBankException("Could not open question bank: " + path);
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart < static_cast<LONGLONG>(HEADER_SIZE))) {
+        CloseHandle(file);
+        throw QuestionBankException("Question bank is truncated: " + path);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr) throw QuestionBankException("Could not map question bank: " + path);
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);  // The view keeps the mapping alive
+
+    if (view == nullptr) throw QuestionBankException("Could not map question bank: " + path);
+
+    data = static_cast<const unsigned char*>(view);
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) throw QuestionBankException("Could not open question bank: " + path);
+
+    struct stat fileInfo;
+
+    if ((fstat(fd, &fileInfo) != 0) || (fileInfo.st_size < static_cast<off_t>(HEADER_SIZE))) {
+        ::close(fd);
+        throw QuestionBankException("Question bank is truncated: " + path);
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+
+    if (view == MAP_FAILED) throw QuestionBankException("Could not map question bank: " + path);
+
+    data = static_cast<const unsigned char*>(view);
+    length = static_cast<std::size_t>(fileInfo.st_size);
+#endif
+
+    // Validate the header against the mapped size
+    try {
+        if (std::memcmp(data, "HGQB", 4) != 0) throw QuestionBankException("Not a question bank: " + path);
+        if (readLE32(data + 4) != BANK_VERSION) throw QuestionBankException("Unsupported question bank version: " + path);
+
+        questionCount = readLE32(data + 8);
+        blobSize = static_cast<std::size_t>(readLE64(data + 16));
+
+        if ((length - HEADER_SIZE) / RECORD_SIZE < questionCount) throw QuestionBankException("Question bank is truncated: " + path);
+        if (length - HEADER_SIZE - (questionCount * RECORD_SIZE) != blobSize) throw QuestionBankException("Question bank size mismatch: " + path);
+
+        records = data + HEADER_SIZE;
+        blob = records + (questionCount * RECORD_SIZE);
+    }
+    catch (...) {
+        close();
+        throw;
+    }
+}
+
+void QuestionBank::close() {
+    if (data != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<unsigned char*>(data), length);
+#endif
+    }
+
+    data = nullptr;
+    length = 0;
+    questionCount = 0;
+    records = nullptr;
+    blob = nullptr;
+    blobSize = 0;
+}
+
+bool QuestionBank::verifyChecksum() const {
+    if (!isOpen()) throw QuestionBankException("Question bank is not open");
+
+    std::uint32_t checksum = fnv1a(records, length - HEADER_SIZE);
+
+    return checksum == readLE32(data + 24);
+}
+
+QuestionView QuestionBank::getQuestion(std::size_t index) const {
+    if (index >= questionCount) throw QuestionBankException("Question index out of range");
+
+    const unsigned char* record = records + (index * RECORD_SIZE);
+
+    return QuestionView{
+        static_cast<std::int32_t>(readLE32(record)),
+        readLE32(record + 4) / DIFFICULTY_SCALE,
+        getString(record + 8),
+        getString(record + 16),
+        getString(record + 24)
+    };
+}
+
+int QuestionBank::getQuestionId(std::size_t index) const {
+    if (index >= questionCount) throw QuestionBankException("Question index out of range");
+
+    return static_cast<std::int32_t>(readLE32(records + (index * RECORD_SIZE)));
+}
+
+double QuestionBank::getDifficulty(std::size_t index) const {
+    if (index >= questionCount) throw QuestionBankException("Question index out of range");
+
+    return readLE32(records + (index * RECORD_SIZE) + 4) / DIFFICULTY_SCALE;
+}
+
+std::uint32_t QuestionBank::getTimesAsked() const {
+    if (!isOpen()) throw QuestionBankException("Question bank is not open");
+
+    return readLE32(data + 12);
+}
+
+QuestionAnswer QuestionBank::getQuestionAnswer(std::size_t index) const {
+    QuestionView view = getQuestion(index);
+    std::vector<std::string> alternates;
+    std::size_t start = 0;
+
+    while (start < view.alternates.size()) {
+        std::size_t tabPos = view.alternates.find('\t', start);
+
+        if (tabPos == std::string_view::npos) tabPos = view.alternates.size();
+
+        alternates.emplace_back(view.alternates.substr(start, tabPos - start));
+        start = tabPos + 1;
+    }
+
+    QuestionAnswer qa(std::string(view.question), std::string(view.answer), alternates, view.id);
+    qa.difficulty = view.difficulty;
+
+    return qa;
+}
+
+std::string_view QuestionBank::getString(const unsigned char* field) const {
+    std::size_t offset = readLE32(field);
+    std::size_t size = readLE32(field + 4);
+
+    // Offsets come from the file, so check them before handing out a view
+    if ((offset > blobSize) || (size > blobSize - offset)) throw QuestionBankException("Question bank string out of range");
+
+    return std::string_view(reinterpret_cast<const char*>(blob + offset), size);
+}
+
+std::uint32_t QuestionBank::readLE32(const unsigned char* bytes) {
+    return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) | (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+std::uint64_t QuestionBank::readLE64(const unsigned char* bytes) {
+    return static_cast<std::uint64_t>(readLE32(bytes)) | (static_cast<std::uint64_t>(readLE32(bytes + 4)) << 32);
+}
+
+void QuestionBank::appendLE(std::string& out, std::uint64_t value, int byteCount) {
+    for (int i = 0; i < byteCount; i++) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+std::uint32_t QuestionBank::fnv1a(const unsigned char* bytes, std::size_t count, std::uint32_t hash) {
+    for (std::size_t i = 0; i < count; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// QUESTION_BANK_CPP
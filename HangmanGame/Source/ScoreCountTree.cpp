@@ -0,0 +1,50 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "ScoreCountTree.h"
+#include <stdexcept>
+
+ScoreCountTree::ScoreCountTree(int maxScore) {
+    if (maxScore < 0) throw std::invalid_argument("Maximum score cannot be negative");
+
+    tree.assign(static_cast<std::size_t>(maxScore) + 2, 0);
+}
+
+void ScoreCountTree::add(int score, long long delta) {
+    if ((score < 0) || (score > getMaxScore())) throw std::out_of_range("Score is outside the tree's range");
+
+    for (std::size_t i = static_cast<std::size_t>(score) + 1; i < tree.size(); i += i & (~i + 1)) tree[i] += delta;
+
+    total += delta;
+}
+
+long long ScoreCountTree::countBelow(int score) const {
+    return prefixSum(score - 1);
+}
+
+long long ScoreCountTree::countAbove(int score) const {
+    return total - prefixSum(score);
+}
+
+long long ScoreCountTree::countAt(int score) const {
+    return prefixSum(score) - prefixSum(score - 1);
+}
+
+long long ScoreCountTree::prefixSum(int score) const {
+    if (score < 0) return 0;
+    if (score > getMaxScore()) return total;
+
+    long long sum = 0;
+
+    for (std::size_t i = static_cast<std::size_t>(score) + 1; i > 0; i -= i & (~i + 1)) sum += tree[i];
+
+    return sum;
+}
+
+// SCORE_COUNT_TREE_CPP
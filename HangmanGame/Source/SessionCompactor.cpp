@@ -0,0 +1,83 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "SessionCompactor.h"
+#include "Database.h"
+
+SessionCompactor::~SessionCompactor() {
+    stop();
+}
+
+void SessionCompactor::start(const std::string& dbPath, int retentionDays) {
+    if (worker.joinable()) throw DatabaseException("Session compaction is already running");
+    if (retentionDays < 1) throw DatabaseException("Retention period must be at least one day");
+
+    stopRequested = false;
+    running = true;
+    compactedCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error.clear();
+    }
+
+    worker = std::thread(&SessionCompactor::run, this, dbPath, retentionDays);
+}
+
+void SessionCompactor::stop() {
+    stopRequested = true;
+
+    if (worker.joinable()) worker.join();
+}
+
+std::string SessionCompactor::getError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+void SessionCompactor::run(const std::string& dbPath, int retentionDays) {
+    try {
+        Database db;
+        db.open(dbPath);
+
+        // Roll up old sessions until none are left
+        while (!stopRequested) {
+            std::size_t compacted = db.compactSessions(retentionDays, BATCH_SIZE);
+
+            if (compacted == 0) break;
+
+            compactedCount += compacted;
+
+            if (!pause()) break;
+        }
+
+        // Then shrink the file a few pages at a time
+        while (!stopRequested) {
+            if (db.incrementalVacuum(VACUUM_PAGES_PER_STEP) == 0) break;
+
+            if (!pause()) break;
+        }
+
+        db.close();
+    }
+    catch (const std::exception& err) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = err.what();
+    }
+
+    running = false;
+}
+
+bool SessionCompactor::pause() {
+    std::this_thread::sleep_for(STEP_PAUSE);
+
+    return !stopRequested;
+}
+
+// SESSION_COMPACTOR_CPP
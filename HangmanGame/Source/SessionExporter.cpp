@@ -0,0 +1,140 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "SessionExporter.h"
+#include <iomanip>
+
+std::size_t SessionExporter::exportSessions(Database& db, const std::string& path, ExportFormat format, std::size_t chunkSize) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file) throw ExportException("Could not open export file: " + path);
+
+    std::map<int, std::string> categories;
+    std::map<int, std::string> modes;
+    std::size_t totalRows = 0;
+
+    try {
+        if (format == ExportFormat::CSV) writeCSVHeader(file);
+        else writeColumnarHeader(file);
+
+        // Only one chunk of rows is in memory at a time
+        totalRows = db.streamGameSessions([&](const std::vector<SessionRecord>& chunk) {
+            if (format == ExportFormat::CSV) {
+                writeCSVChunk(file, chunk);
+            }
+            else {
+                for (const SessionRecord& record : chunk) {
+                    categories.emplace(record.categoryId, record.categoryName);
+                    modes.emplace(record.modeId, record.modeName);
+                }
+
+                writeColumnarChunk(file, chunk);
+            }
+
+            if (!file) throw ExportException("Write failed: " + path);
+        }, chunkSize);
+
+        if (format == ExportFormat::COLUMNAR) {
+            writeLE(file, 0, 4);  // Empty block ends the block list
+            writeColumnarTrailer(file, categories, modes, totalRows);
+        }
+
+        file.close();
+
+        if (!file) throw ExportException("Write failed: " + path);
+    }
+    catch (const std::exception& err) {
+        throw ExportException("Failed to export game sessions: " + std::string(err.what()));
+    }
+
+    return totalRows;
+}
+
+void SessionExporter::writeCSVHeader(std::ofstream& file) {
+    file << "session_id,player_id,player_name,category,mode,score,played_at\n";
+}
+
+void SessionExporter::writeCSVChunk(std::ofstream& file, const std::vector<SessionRecord>& chunk) {
+    for (const SessionRecord& record : chunk) {
+        file << record.sessionId << ','
+            << record.playerId << ','
+            << escapeCSV(record.playerName) << ','
+            << record.categoryName << ','
+            << record.modeName << ','
+            << (record.scoreCenti / 100) << '.' << std::setw(2) << std::setfill('0') << (record.scoreCenti % 100) << ','
+            << record.playedAt << '\n';
+    }
+}
+
+void SessionExporter::writeColumnarHeader(std::ofstream& file) {
+    file.write("HGSX", 4);
+    writeLE(file, COLUMNAR_VERSION, 4);
+    writeLE(file, COLUMN_COUNT, 4);
+}
+
+void SessionExporter::writeColumnarChunk(std::ofstream& file, const std::vector<SessionRecord>& chunk) {
+    writeLE(file, chunk.size(), 4);
+
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint64_t>(record.sessionId), 8);
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint32_t>(record.playerId), 4);
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint16_t>(record.categoryId), 2);
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint16_t>(record.modeId), 2);
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint32_t>(record.scoreCenti), 4);
+    for (const SessionRecord& record : chunk) writeLE(file, static_cast<std::uint64_t>(record.playedAt), 8);
+
+    // Player names: offset table, then one contiguous string blob
+    std::uint32_t offset = 0;
+    writeLE(file, offset, 4);
+
+    for (const SessionRecord& record : chunk) {
+        offset += static_cast<std::uint32_t>(record.playerName.size());
+        writeLE(file, offset, 4);
+    }
+
+    for (const SessionRecord& record : chunk) file.write(record.playerName.data(), static_cast<std::streamsize>(record.playerName.size()));
+}
+
+void SessionExporter::writeColumnarTrailer(std::ofstream& file, const std::map<int, std::string>& categories, const std::map<int, std::string>& modes, std::uint64_t totalRows) {
+    for (const std::map<int, std::string>* dictionary : { &categories, &modes }) {
+        writeLE(file, dictionary->size(), 4);
+
+        for (const auto& [id, name] : *dictionary) {
+            writeLE(file, static_cast<std::uint16_t>(id), 2);
+            writeLE(file, static_cast<std::uint16_t>(name.size()), 2);
+            file.write(name.data(), static_cast<std::streamsize>(name.size()));
+        }
+    }
+
+    writeLE(file, totalRows, 8);
+}
+
+std::string SessionExporter::escapeCSV(const std::string& value) {
+    if (value.find_first_of(",\"\n\r") == std::string::npos) return value;
+
+    std::string escaped = "\"";
+
+    for (char c : value) {
+        if (c == '"') escaped += '"';
+        escaped += c;
+    }
+
+    escaped += '"';
+
+    return escaped;
+}
+
+void SessionExporter::writeLE(std::ofstream& file, std::uint64_t value, int byteCount) {
+    char bytes[8];
+
+    for (int i = 0; i < byteCount; i++) bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+
+    file.write(bytes, byteCount);
+}
+
+// SESSION_EXPORTER_CPP
@@ -0,0 +1,119 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "ShardedDatabase.h"
+#include <filesystem>
+
+ShardedDatabase::ShardedDatabase(const std::string& shardFolder, std::size_t readersPerShard, bool enableQueryProfiling) : shardFolder(shardFolder) {
+    try {
+        std::filesystem::create_directories(shardFolder);
+
+        // The players file uses the same schema, only its Players table is ever filled
+        players.setQueryProfiling(enableQueryProfiling);
+        players.open(getPlayersPath());
+        players.createTables();
+        players.enableWriteAheadLog();
+
+        for (Category category : CATEGORIES) {
+            Database setup;
+            setup.initializeShard(getShardPath(category), category);
+
+            shards[category] = std::make_unique<SharedDatabase>(getShardPath(category), readersPerShard, enableQueryProfiling);
+        }
+    }
+    catch (const std::exception& err) {
+        throw DatabaseException("Failed to open sharded database: " + std::string(err.what()));
+    }
+}
+
+int ShardedDatabase::addPlayer(const std::string& playerName) {
+    std::lock_guard<std::mutex> lock(playersMutex);
+
+    int playerId = players.addPlayer(playerName);
+
+    // Copied into every shard once, after that the player's games only touch their category's file
+    if (importedPlayers.count(playerId) == 0) {
+        for (auto& [category, shard] : shards) shard->importPlayer(getPlayersPath(), playerId);
+
+        importedPlayers.insert(playerId);
+    }
+
+    return playerId;
+}
+
+double ShardedDatabase::getAverageScore(int playerId) {
+    long long totalCenti = 0;
+    long long sessionCount = 0;
+
+    for (auto& [category, shard] : shards) {
+        auto [shardTotal, shardCount] = shard->getScoreTotals(playerId);
+
+        totalCenti += shardTotal;
+        sessionCount += shardCount;
+    }
+
+    if (sessionCount == 0) return -1.0;
+
+    return (static_cast<double>(totalCenti) / 100.0) / static_cast<double>(sessionCount);
+}
+
+void ShardedDatabase::saveScore(int playerId, Category category, GameMode mode, int scoreCenti) {
+    getShard(category).saveScore(playerId, category, mode, scoreCenti);
+}
+
+void ShardedDatabase::saveQuestionStats(Category category, const std::vector<QuestionStat>& stats) {
+    getShard(category).saveQuestionStats(stats);
+}
+
+std::vector<QuestionAnswer> ShardedDatabase::getQuestions(Category category) {
+    return getShard(category).getQuestions(category);
+}
+
+std::vector<std::string> ShardedDatabase::getHighScores(Category category, GameMode mode, LeaderboardWindow window) {
+    return getShard(category).getHighScores(category, mode, window);
+}
+
+std::vector<std::pair<std::string, int>> ShardedDatabase::getTopScores(Category category, GameMode mode, int limit, LeaderboardWindow window) {
+    return getShard(category).getTopScores(category, mode, limit, window);
+}
+
+int ShardedDatabase::getPlayerRank(int playerId, Category category, GameMode mode) {
+    return getShard(category).getPlayerRank(playerId, category, mode);
+}
+
+double ShardedDatabase::getPercentile(int scoreCenti, Category category, GameMode mode) {
+    return getShard(category).getPercentile(scoreCenti, category, mode);
+}
+
+void ShardedDatabase::collectStatistics(Database& target) {
+    {
+        std::lock_guard<std::mutex> lock(playersMutex);
+        target.mergeStatistics(players);
+    }
+
+    for (auto& [category, shard] : shards) shard->collectStatistics(target);
+}
+
+std::string ShardedDatabase::getShardPath(Category category) const {
+    return shardFolder + "/" + Hangman::categoryToString(category) + ".db";
+}
+
+std::string ShardedDatabase::getPlayersPath() const {
+    return shardFolder + "/Players.db";
+}
+
+SharedDatabase& ShardedDatabase::getShard(Category category) {
+    auto found = shards.find(category);
+
+    if (found == shards.end()) throw DatabaseException("No database shard for category " + Hangman::categoryToString(category));
+
+    return *found->second;
+}
+
+// SHARDED_DATABASE_CPP
@@ -0,0 +1,120 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "SharedDatabase.h"
+
+SharedDatabase::SharedDatabase(const std::string& dbPath, std::size_t readerCount, bool enableQueryProfiling) {
+    if (readerCount == 0) throw DatabaseException("A shared database needs at least one reader");
+
+    writer.setQueryProfiling(enableQueryProfiling);
+    writer.open(dbPath);
+    writer.enableWriteAheadLog();
+
+    for (std::size_t i = 0; i < readerCount; i++) {
+        auto reader = std::make_unique<Database>();
+
+        reader->setQueryProfiling(enableQueryProfiling);
+        reader->open(dbPath, true);
+
+        idleReaders.push_back(reader.get());
+        readers.push_back(std::move(reader));
+    }
+}
+
+int SharedDatabase::addPlayer(const std::string& playerName) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return writer.addPlayer(playerName);
+}
+
+void SharedDatabase::saveScore(int playerId, Category category, GameMode mode, int scoreCenti) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writer.saveScore(playerId, category, mode, scoreCenti);
+}
+
+void SharedDatabase::saveQuestionStats(const std::vector<QuestionStat>& stats) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writer.saveQuestionStats(stats);
+}
+
+void SharedDatabase::loadAllQuestionFiles() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writer.loadAllQuestionFiles();
+}
+
+void SharedDatabase::loadQuestionsFromTSV(const std::string& filePath, const std::string& category) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writer.loadQuestionsFromTSV(filePath, category);
+}
+
+void SharedDatabase::importPlayer(const std::string& playersDbPath, int playerId) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writer.importPlayer(playersDbPath, playerId);
+}
+
+std::vector<QuestionAnswer> SharedDatabase::getQuestions(Category category) {
+    return acquireReader()->getQuestions(category);
+}
+
+std::vector<std::string> SharedDatabase::getHighScores(Category category, GameMode mode, LeaderboardWindow window) {
+    return acquireReader()->getHighScores(category, mode, window);
+}
+
+std::vector<std::pair<std::string, int>> SharedDatabase::getTopScores(Category category, GameMode mode, int limit, LeaderboardWindow window) {
+    return acquireReader()->getTopScores(category, mode, limit, window);
+}
+
+double SharedDatabase::getAverageScore(int playerId) {
+    return acquireReader()->getAverageScore(playerId);
+}
+
+std::pair<long long, long long> SharedDatabase::getScoreTotals(int playerId) {
+    return acquireReader()->getScoreTotals(playerId);
+}
+
+int SharedDatabase::getPlayerRank(int playerId, Category category, GameMode mode) {
+    return acquireReader()->getPlayerRank(playerId, category, mode);
+}
+
+double SharedDatabase::getPercentile(int scoreCenti, Category category, GameMode mode) {
+    return acquireReader()->getPercentile(scoreCenti, category, mode);
+}
+
+void SharedDatabase::collectStatistics(Database& target) {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        target.mergeStatistics(writer);
+    }
+
+    // Holding the pool lock until every reader is idle keeps their statistics still while they are read
+    std::unique_lock<std::mutex> lock(readerMutex);
+    readerReleased.wait(lock, [this] { return idleReaders.size() == readers.size(); });
+
+    for (const auto& reader : readers) target.mergeStatistics(*reader);
+}
+
+SharedDatabase::ReaderLease SharedDatabase::acquireReader() {
+    std::unique_lock<std::mutex> lock(readerMutex);
+    readerReleased.wait(lock, [this] { return !idleReaders.empty(); });
+
+    Database* reader = idleReaders.back();
+    idleReaders.pop_back();
+
+    return ReaderLease(*this, *reader);
+}
+
+void SharedDatabase::releaseReader(Database& reader) {
+    {
+        std::lock_guard<std::mutex> lock(readerMutex);
+        idleReaders.push_back(&reader);
+    }
+
+    readerReleased.notify_all();
+}
+
+// SHARED_DATABASE_CPP
@@ -0,0 +1,88 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "SnapshotScheduler.h"
+
+SnapshotScheduler::~SnapshotScheduler() {
+    stop();
+}
+
+void SnapshotScheduler::start(const std::string& dbPath, const std::string& snapshotPath, std::chrono::seconds interval) {
+    if (worker.joinable()) throw DatabaseException("Snapshots are already being taken");
+    if (interval.count() < 1) throw DatabaseException("Snapshot interval must be at least one second");
+
+    // Opened here so the database is held open from the moment start returns
+    source.open(dbPath);
+
+    this->snapshotPath = snapshotPath;
+    this->interval = interval;
+
+    stopRequested = false;
+    running = true;
+    snapshotCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error.clear();
+    }
+
+    worker = std::thread(&SnapshotScheduler::run, this);
+}
+
+void SnapshotScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+
+    stopSignal.notify_all();
+
+    if (worker.joinable()) worker.join();
+
+    source.close();
+}
+
+std::string SnapshotScheduler::getError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+void SnapshotScheduler::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stopMutex);
+
+            if (stopSignal.wait_for(lock, interval, [this] { return stopRequested; })) break;
+        }
+
+        writeSnapshot();
+    }
+
+    // Final flush of everything saved since the last snapshot
+    writeSnapshot();
+
+    running = false;
+}
+
+void SnapshotScheduler::writeSnapshot() {
+    try {
+        source.saveSnapshot(snapshotPath);
+        snapshotCount++;
+
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error.clear();
+    }
+    catch (const std::exception& err) {
+        // Kept for the caller, the next snapshot tries again
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = err.what();
+    }
+}
+
+// SNAPSHOT_SCHEDULER_CPP
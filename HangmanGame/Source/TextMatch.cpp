@@ -0,0 +1,354 @@
+/*
+Name: Emmanuel Rivas
+ID: 15310887
+Class: Fall 2024, CSC 211H
+Date: 02/01/2025
+Instructor: Dr. Azhar
+Honors Project: Hangman
+*/
+
+#include "TextMatch.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define TEXT_MATCH_USE_SSE2
+#endif
+
+std::string TextMatch::foldCase(std::string_view text) {
+    std::string folded;
+    folded.reserve(text.size());
+
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        unsigned char byte = static_cast<unsigned char>(text[pos]);
+
+        if (byte < 0x80) {  // ASCII
+            folded += static_cast<char>(((byte >= 'A') && (byte <= 'Z')) ? (byte | 0x20) : byte);
+            pos++;
+        }
+        else {
+            char encoded[4];
+            folded.append(encoded, foldNext(text, pos, encoded));
+        }
+    }
+
+    return folded;
+}
+
+bool TextMatch::equalsFolded(std::string_view guess, std::string_view foldedAnswer) {
+    std::size_t mismatchOffset = 0;
+
+    // Fast path: both strings are ASCII, where folding never changes the length
+    if (guess.size() == foldedAnswer.size()) {
+        if (equalsFoldedAscii(guess.data(), foldedAnswer.data(), guess.size(), mismatchOffset)) return true;
+    }
+
+    // A non-ASCII byte stopped the fast path, so compare code point by code point
+    bool hasNonAscii = false;
+
+    for (std::size_t i = mismatchOffset; i < guess.size() && !hasNonAscii; i++) hasNonAscii = (static_cast<unsigned char>(guess[i]) >= 0x80);
+    for (std::size_t i = mismatchOffset; i < foldedAnswer.size() && !hasNonAscii; i++) hasNonAscii = (static_cast<unsigned char>(foldedAnswer[i]) >= 0x80);
+
+    return hasNonAscii && equalsFoldedUnicode(guess, foldedAnswer);
+}
+
+bool TextMatch::equalsFoldedAscii(const char* guess, const char* foldedAnswer, std::size_t length, std::size_t& mismatchOffset) {
+    std::size_t i = 0;
+
+    #ifdef TEXT_MATCH_USE_SSE2
+        const __m128i upperLow = _mm_set1_epi8('A' - 1);
+        const __m128i upperHigh = _mm_set1_epi8('Z' + 1);
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+
+        // 16 bytes at a time: bail out on any non-ASCII byte, fold A-Z in the guess, then compare
+        for (; (i + 16) <= length; i += 16) {
+            __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(guess + i));
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(foldedAnswer + i));
+
+            if (_mm_movemask_epi8(_mm_or_si128(g, a)) != 0) {
+                mismatchOffset = i;
+                return false;
+            }
+
+            __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(g, upperLow), _mm_cmplt_epi8(g, upperHigh));
+            __m128i folded = _mm_or_si128(g, _mm_and_si128(isUpper, caseBit));
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(folded, a)) != 0xFFFF) {
+                mismatchOffset = i;
+                return false;
+            }
+        }
+    #endif
+
+    // Scalar tail (or whole string without SSE2)
+    for (; i < length; i++) {
+        unsigned char g = static_cast<unsigned char>(guess[i]);
+        unsigned char a = static_cast<unsigned char>(foldedAnswer[i]);
+
+        if ((g | a) >= 0x80) {
+            mismatchOffset = i;
+            return false;
+        }
+
+        if ((g >= 'A') && (g <= 'Z')) g |= 0x20;
+
+        if (g != a) {
+            mismatchOffset = i;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TextMatch::equalsFoldedUnicode(std::string_view guess, std::string_view foldedAnswer) {
+    std::size_t guessPos = 0;
+    std::size_t answerPos = 0;
+
+    while ((guessPos < guess.size()) && (answerPos < foldedAnswer.size())) {
+        if (foldCodePoint(decodeUtf8(guess, guessPos)) != decodeUtf8(foldedAnswer, answerPos)) return false;
+    }
+
+    return (guessPos == guess.size()) && (answerPos == foldedAnswer.size());
+}
+
+std::size_t TextMatch::normalize(std::string_view text, char* out, std::size_t capacity) {
+    std::size_t length = 0;
+    bool pendingSpace = false;
+    std::size_t pos = 0;
+
+    while ((pos < text.size()) && (length < capacity)) {
+        unsigned char byte = static_cast<unsigned char>(text[pos]);
+
+        if (byte < 0x80) {
+            pos++;
+
+            // Whitespace and punctuation both separate words
+            if (!(((byte >= 'a') && (byte <= 'z')) || ((byte >= 'A') && (byte <= 'Z')) || ((byte >= '0') && (byte <= '9')))) {
+                pendingSpace = (length > 0);
+                continue;
+            }
+
+            if (pendingSpace) {
+                out[length++] = ' ';
+                pendingSpace = false;
+
+                if (length == capacity) break;
+            }
+
+            out[length++] = static_cast<char>(((byte >= 'A') && (byte <= 'Z')) ? (byte | 0x20) : byte);
+        }
+        else {
+            // Fold into a small buffer first so the output can be truncated cleanly
+            char encoded[4];
+            std::size_t encodedLength = foldNext(text, pos, encoded);
+
+            if (length + (pendingSpace ? 1 : 0) + encodedLength > capacity) break;
+
+            if (pendingSpace) {
+                out[length++] = ' ';
+                pendingSpace = false;
+            }
+
+            std::memcpy(out + length, encoded, encodedLength);
+            length += encodedLength;
+        }
+    }
+
+    return length;
+}
+
+std::size_t TextMatch::foldNext(std::string_view text, std::size_t& pos, char* out) {
+    char32_t codePoint = foldCodePoint(decodeUtf8(text, pos));
+    std::size_t length = 0;
+
+    if (codePoint < 0x80) {
+        out[length++] = static_cast<char>(codePoint);
+    }
+    else if (codePoint < 0x800) {
+        out[length++] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000) {
+        out[length++] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[length++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else {
+        out[length++] = static_cast<char>(0xF0 | (codePoint >> 18));
+        out[length++] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out[length++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+
+    return length;
+}
+
+std::string TextMatch::normalize(std::string_view text) {
+    std::string normalized(text.size() * 2, '\0');  // Folding can at most double a UTF-8 sequence
+    normalized.resize(normalize(text, normalized.data(), normalized.size()));
+
+    return normalized;
+}
+
+int TextMatch::boundedEditDistance(std::string_view a, std::string_view b, int maxDistance) {
+    maxDistance = std::clamp(maxDistance, 0, MAX_EDIT_DISTANCE);
+
+    // The length difference alone is a lower bound on the distance
+    int lengthDifference = static_cast<int>(a.size() > b.size() ? a.size() - b.size() : b.size() - a.size());
+
+    if (lengthDifference > maxDistance) return maxDistance + 1;
+    if (a.empty() || b.empty()) return lengthDifference;
+
+    // Bit-parallel kernel when the shorter string fits in one machine word
+    if (a.size() > b.size()) std::swap(a, b);
+
+    return (a.size() <= 64) ? myersEditDistance(a, b, maxDistance) : bandedEditDistance(a, b, maxDistance);
+}
+
+int TextMatch::myersEditDistance(std::string_view pattern, std::string_view text, int maxDistance) {
+    // Myers/Hyyro bit-vector algorithm: one column of the DP matrix per text character
+    std::uint64_t peq[256];
+    std::memset(peq, 0, sizeof(peq));
+
+    for (std::size_t i = 0; i < pattern.size(); i++) peq[static_cast<unsigned char>(pattern[i])] |= (std::uint64_t(1) << i);
+
+    const std::uint64_t lastBit = std::uint64_t(1) << (pattern.size() - 1);
+    std::uint64_t pv = ~std::uint64_t(0);
+    std::uint64_t mv = 0;
+    int score = static_cast<int>(pattern.size());
+    int remaining = static_cast<int>(text.size());
+
+    for (char c : text) {
+        std::uint64_t eq = peq[static_cast<unsigned char>(c)];
+        std::uint64_t xv = eq | mv;
+        std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+
+        if (ph & lastBit) score++;
+        else if (mh & lastBit) score--;
+
+        ph = (ph << 1) | 1;  // Row 0 of the matrix grows by one per column (global alignment)
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // The score can drop by at most one per remaining column
+        remaining--;
+        if (score - remaining > maxDistance) return maxDistance + 1;
+    }
+
+    return (score > maxDistance) ? (maxDistance + 1) : score;
+}
+
+int TextMatch::bandedEditDistance(std::string_view a, std::string_view b, int maxDistance) {
+    // Only cells within maxDistance of the diagonal can stay within budget
+    constexpr int BAND_SIZE = (2 * MAX_EDIT_DISTANCE) + 3;
+    const int unreachable = maxDistance + 1;
+    int previous[BAND_SIZE];
+    int current[BAND_SIZE];
+
+    // Band slot k of row i holds column j = i + k - maxDistance
+    for (int k = 0; k < BAND_SIZE; k++) {
+        int j = k - maxDistance;
+        previous[k] = ((j >= 0) && (j <= maxDistance)) ? j : unreachable;
+    }
+
+    const int rows = static_cast<int>(a.size());
+    const int columns = static_cast<int>(b.size());
+
+    for (int i = 1; i <= rows; i++) {
+        int rowMinimum = unreachable;
+
+        for (int k = 0; k <= (2 * maxDistance); k++) {
+            int j = i + k - maxDistance;
+            int value = unreachable;
+
+            if ((j >= 0) && (j <= columns)) {
+                if (j == 0) {
+                    value = i;
+                }
+                else {
+                    int substitution = previous[k] + ((a[i - 1] == b[j - 1]) ? 0 : 1);
+                    int deletion = previous[k + 1] + 1;
+                    int insertion = ((k > 0) ? current[k - 1] : unreachable) + 1;
+
+                    value = std::min({ substitution, deletion, insertion });
+                }
+            }
+
+            current[k] = std::min(value, unreachable);
+            rowMinimum = std::min(rowMinimum, current[k]);
+        }
+
+        current[(2 * maxDistance) + 1] = unreachable;
+
+        if (rowMinimum > maxDistance) return unreachable;
+
+        std::copy(current, current + BAND_SIZE, previous);
+    }
+
+    int finalSlot = columns - rows + maxDistance;
+
+    return ((finalSlot >= 0) && (finalSlot <= (2 * maxDistance))) ? previous[finalSlot] : unreachable;
+}
+
+char32_t TextMatch::decodeUtf8(std::string_view text, std::size_t& pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    char32_t codePoint = 0;
+    int continuationBytes = 0;
+
+    if (lead < 0x80) {
+        codePoint = lead;
+    }
+    else if ((lead & 0xE0) == 0xC0) {
+        codePoint = lead & 0x1F;
+        continuationBytes = 1;
+    }
+    else if ((lead & 0xF0) == 0xE0) {
+        codePoint = lead & 0x0F;
+        continuationBytes = 2;
+    }
+    else if ((lead & 0xF8) == 0xF0) {
+        codePoint = lead & 0x07;
+        continuationBytes = 3;
+    }
+    else {  // Stray continuation or invalid byte, passed through as-is
+        pos++;
+        return lead;
+    }
+
+    pos++;
+
+    for (int i = 0; (i < continuationBytes) && (pos < text.size()); i++) {
+        unsigned char byte = static_cast<unsigned char>(text[pos]);
+
+        if ((byte & 0xC0) != 0x80) break;  // Truncated sequence
+
+        codePoint = (codePoint << 6) | (byte & 0x3F);
+        pos++;
+    }
+
+    return codePoint;
+}
+
+char32_t TextMatch::foldCodePoint(char32_t codePoint) {
+    char32_t folded = codePoint;
+
+    // Simple one-to-one lowercase mappings for the Latin, Greek and Cyrillic capital letter blocks
+    if ((codePoint >= U'A') && (codePoint <= U'Z')) folded = codePoint + 0x20;
+    else if ((codePoint >= 0x00C0) && (codePoint <= 0x00DE) && (codePoint != 0x00D7)) folded = codePoint + 0x20;
+    else if ((((codePoint >= 0x0100) && (codePoint <= 0x012F)) || ((codePoint >= 0x0132) && (codePoint <= 0x0137)) || ((codePoint >= 0x014A) && (codePoint <= 0x0177))) && ((codePoint & 1) == 0)) folded = codePoint + 1;
+    else if ((((codePoint >= 0x0139) && (codePoint <= 0x0148)) || ((codePoint >= 0x0179) && (codePoint <= 0x017E))) && ((codePoint & 1) == 1)) folded = codePoint + 1;
+    else if ((codePoint >= 0x0391) && (codePoint <= 0x03A9) && (codePoint != 0x03A2)) folded = codePoint + 0x20;
+    else if ((codePoint >= 0x0400) && (codePoint <= 0x040F)) folded = codePoint + 0x50;
+    else if ((codePoint >= 0x0410) && (codePoint <= 0x042F)) folded = codePoint + 0x20;
+
+    return folded;
+}
+
+// TEXT_MATCH_CPP
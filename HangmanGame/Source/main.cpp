@@ -10,26 +10,227 @@ Honors Project: Hangman
 #include "Database.h"
 #include "Hangman.h"
 #include "Display.h"
+#include "Profiler.h"
+#include "SessionExporter.h"
+#include "QuestionBank.h"
+#include "GameLog.h"
+#include "GameRegistry.h"
+#include "GameEngine.h"
+#include "SessionCompactor.h"
+#include "SharedDatabase.h"
+#include "ShardedDatabase.h"
+#include "SnapshotScheduler.h"
+#include "BackupScheduler.h"
 #include <iostream>
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <cstdlib>
 #include <thread>
 #include <chrono>
+#include <future>
+#include <algorithm>
+#include <map>
+#include <memory>
 
 // Anonymous namespace for encapsulation
 namespace {
     // Constants
     const std::string DB_NAME = "Hangman_DB.db";
     const std::string DB_FOLDER = "Data/SQLite_DB";
+    const std::string SHARD_FOLDER = "Data/SQLite_DB/Shards";
     const std::string RESOURCES_FOLDER = "Data/Resources";
+    const std::string QUESTION_BANK_FOLDER = "Data/QuestionBank";
+    const std::string EVENT_LOG_PATH = "Data/Logs/game_events.log";
+    const std::string BACKUP_FOLDER = "Data/Backups";
+    const int DEFAULT_RETENTION_DAYS = 90;
+    const int DEFAULT_SNAPSHOT_SECONDS = 30;
+    const int DEFAULT_BACKUP_MINUTES = 60;
+    const std::size_t READER_COUNT = 2;  // Gameplay reads come from the game thread and the question prefetch
     const std::vector<std::string> CATEGORY_FILES = {
         "CSC_111.tsv",
         "CSC_211.tsv",
         "CSC_231.tsv"
     };
 
+    // Command line options
+    struct LaunchOptions {
+        std::string gameName = "Hangman";
+        bool enableProfiling = false;
+        ProfileFormat profileFormat = ProfileFormat::JSON;
+        std::string profileOutputPath = "";
+        bool enableQueryProfiling = false;
+        std::string queryProfileOutputPath = "sql_profile.txt";
+        bool fuzzyClassic = false;
+        bool fuzzyTest = false;
+        SelectionPolicy selectionPolicy = SelectionPolicy::ADAPTIVE;
+        LeaderboardWindow leaderboardWindow = LeaderboardWindow::ALL_TIME;
+        bool useQuestionBank = false;
+        std::string eventLogPath = "";
+        std::string replayLogPath = "";
+        bool recoverGames = false;  // Saves the scores of logged games that never reached the database
+        std::string exportPath = "";
+        ExportFormat exportFormat = ExportFormat::CSV;
+        int retentionDays = 0;  // 0 keeps every session
+        bool rebuildHighScores = false;
+        bool sharded = false;  // One database file per category
+        int snapshotSeconds = 0;  // 0 plays on the database file, otherwise in memory with snapshots this often
+        int backupMinutes = 0;    // 0 takes no backups
+    };
+
     // Helper functions
+    LaunchOptions parseArguments(int argc, char* argv[]) {
+        LaunchOptions options;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg.rfind("--game=", 0) == 0) {
+                options.gameName = arg.substr(std::string("--game=").size());
+
+                if (!GameRegistry::isRegistered(options.gameName)) throw std::invalid_argument("Unknown game: " + options.gameName);
+            }
+            else if (arg == "--profile" || arg == "--profile=json") {
+                options.enableProfiling = true;
+                options.profileFormat = ProfileFormat::JSON;
+            }
+            else if (arg == "--profile=trace") {
+                options.enableProfiling = true;
+                options.profileFormat = ProfileFormat::CHROME_TRACE;
+            }
+            else if (arg.rfind("--profile-out=", 0) == 0) {
+                options.profileOutputPath = arg.substr(std::string("--profile-out=").size());
+            }
+            else if (arg == "--profile-sql") {
+                options.enableQueryProfiling = true;
+            }
+            else if (arg.rfind("--profile-sql=", 0) == 0) {
+                options.enableQueryProfiling = true;
+                options.queryProfileOutputPath = arg.substr(std::string("--profile-sql=").size());
+            }
+            else if (arg == "--fuzzy" || arg == "--fuzzy=all") {
+                options.fuzzyClassic = true;
+                options.fuzzyTest = true;
+            }
+            else if (arg == "--fuzzy=classic") {
+                options.fuzzyClassic = true;
+            }
+            else if (arg == "--fuzzy=test") {
+                options.fuzzyTest = true;
+            }
+            else if (arg == "--selection=uniform") {
+                options.selectionPolicy = SelectionPolicy::UNIFORM;
+            }
+            else if (arg == "--selection=adaptive") {
+                options.selectionPolicy = SelectionPolicy::ADAPTIVE;
+            }
+            else if (arg == "--leaderboard=daily") {
+                options.leaderboardWindow = LeaderboardWindow::DAILY;
+            }
+            else if (arg == "--leaderboard=weekly") {
+                options.leaderboardWindow = LeaderboardWindow::WEEKLY;
+            }
+            else if (arg == "--leaderboard=all") {
+                options.leaderboardWindow = LeaderboardWindow::ALL_TIME;
+            }
+            else if (arg == "--question-bank") {
+                options.useQuestionBank = true;
+            }
+            else if (arg == "--event-log") {
+                options.eventLogPath = EVENT_LOG_PATH;
+            }
+            else if (arg.rfind("--event-log=", 0) == 0) {
+                options.eventLogPath = arg.substr(std::string("--event-log=").size());
+            }
+            else if (arg.rfind("--replay-log=", 0) == 0) {
+                options.replayLogPath = arg.substr(std::string("--replay-log=").size());
+            }
+            else if (arg == "--recover") {
+                options.recoverGames = true;
+            }
+            else if (arg.rfind("--export-sessions=", 0) == 0) {
+                options.exportPath = arg.substr(std::string("--export-sessions=").size());
+            }
+            else if (arg == "--rebuild-high-scores") {
+                options.rebuildHighScores = true;
+            }
+            else if (arg == "--compact") {
+                options.retentionDays = DEFAULT_RETENTION_DAYS;
+            }
+            else if (arg.rfind("--compact=", 0) == 0) {
+                const std::string days = arg.substr(std::string("--compact=").size());
+
+                if (days.empty() || (days.find_first_not_of("0123456789") != std::string::npos) || (days.size() > 5) || (std::stoi(days) < 1)) {
+                    throw std::invalid_argument("Invalid retention period: " + days);
+                }
+
+                options.retentionDays = std::stoi(days);
+            }
+            else if (arg == "--in-memory") {
+                options.snapshotSeconds = DEFAULT_SNAPSHOT_SECONDS;
+            }
+            else if (arg.rfind("--in-memory=", 0) == 0) {
+                const std::string seconds = arg.substr(std::string("--in-memory=").size());
+
+                if (seconds.empty() || (seconds.find_first_not_of("0123456789") != std::string::npos) || (seconds.size() > 5) || (std::stoi(seconds) < 1)) {
+                    throw std::invalid_argument("Invalid snapshot interval: " + seconds);
+                }
+
+                options.snapshotSeconds = std::stoi(seconds);
+            }
+            else if (arg == "--backup") {
+                options.backupMinutes = DEFAULT_BACKUP_MINUTES;
+            }
+            else if (arg.rfind("--backup=", 0) == 0) {
+                const std::string minutes = arg.substr(std::string("--backup=").size());
+
+                if (minutes.empty() || (minutes.find_first_not_of("0123456789") != std::string::npos) || (minutes.size() > 5) || (std::stoi(minutes) < 1)) {
+                    throw std::invalid_argument("Invalid backup interval: " + minutes);
+                }
+
+                options.backupMinutes = std::stoi(minutes);
+            }
+            else if (arg == "--sharded") {
+                options.sharded = true;
+            }
+            else if (arg == "--export-format=csv") {
+                options.exportFormat = ExportFormat::CSV;
+            }
+            else if (arg == "--export-format=columnar") {
+                options.exportFormat = ExportFormat::COLUMNAR;
+            }
+            else {
+                throw std::invalid_argument("Unknown command line option: " + arg);
+            }
+        }
+
+        if (options.enableProfiling && options.profileOutputPath.empty()) {
+            options.profileOutputPath = (options.profileFormat == ProfileFormat::CHROME_TRACE) ? "profile_trace.json" : "profile.json";
+        }
+
+        if (options.recoverGames && options.replayLogPath.empty()) throw std::invalid_argument("--recover needs --replay-log");
+
+        // Question banks and compaction read the single database file
+        if (options.sharded && options.useQuestionBank) throw std::invalid_argument("--sharded cannot be combined with --question-bank");
+        if (options.sharded && (options.retentionDays > 0)) throw std::invalid_argument("--sharded cannot be combined with --compact");
+        if (options.sharded && (options.snapshotSeconds > 0)) throw std::invalid_argument("--sharded cannot be combined with --in-memory");
+        if (options.sharded && (options.backupMinutes > 0)) throw std::invalid_argument("--sharded cannot be combined with --backup");
+
+        // Shard question IDs restart in every file, so the log could not be replayed against the questions it names
+        if (options.sharded && !options.eventLogPath.empty()) throw std::invalid_argument("--sharded cannot be combined with --event-log");
+
+        return options;
+    }
+
+    // Typo-tolerant answer matching is opt-in per mode
+    void applyAnswerMatching(Hangman& game, const LaunchOptions& options) {
+        AnswerMatchSettings fuzzyMatching;
+        fuzzyMatching.allowTypos = true;
+
+        if (options.fuzzyClassic) game.setAnswerMatching(GameMode::CLASSIC, fuzzyMatching);
+        if (options.fuzzyTest) game.setAnswerMatching(GameMode::TEST, fuzzyMatching);
+    }
+
     bool ensureDirectoryExists(const std::string& path) {
         bool directoryExists = false;
 
@@ -47,6 +248,9 @@ namespace {
 
     void initializeDatabase(Database& db) {
         try {
+            // Timed inside the try block, so the pause for Enter below is not counted
+            PROFILE_SCOPE("main::initializeDatabase");
+
             // Ensure database directory exists
             if (ensureDirectoryExists(DB_FOLDER) == false) std::filesystem::create_directories(DB_FOLDER);
 
@@ -60,6 +264,220 @@ namespace {
         Display::pauseScreen();
     }
 
+    // The in-memory database only lives while a connection is open, the snapshot scheduler's keeps it
+    void initializeMemoryDatabase(Database& db, SnapshotScheduler& snapshots, const LaunchOptions& options) {
+        try {
+            PROFILE_SCOPE("main::initializeMemoryDatabase");
+
+            if (ensureDirectoryExists(DB_FOLDER) == false) std::filesystem::create_directories(DB_FOLDER);
+
+            db.initializeInMemory(getDBPath());
+            snapshots.start(Database::MEMORY_DB_PATH, getDBPath(), std::chrono::seconds(options.snapshotSeconds));
+            db.close();
+        }
+        catch (const std::exception& err) {
+            throw std::runtime_error("Database initialization failed: " + std::string(err.what()));
+        }
+
+        Display::pauseScreen();
+    }
+
+    std::unique_ptr<ShardedDatabase> initializeShards(const LaunchOptions& options) {
+        std::unique_ptr<ShardedDatabase> shardedDb;
+
+        try {
+            PROFILE_SCOPE("main::initializeShards");
+
+            shardedDb = std::make_unique<ShardedDatabase>(SHARD_FOLDER, READER_COUNT, options.enableQueryProfiling);
+        }
+        catch (const std::exception& err) {
+            throw std::runtime_error("Database initialization failed: " + std::string(err.what()));
+        }
+
+        Display::pauseScreen();
+
+        return shardedDb;
+    }
+
+    std::string getQuestionBankPath(Category category) {
+        std::string path = "";
+        path = QUESTION_BANK_FOLDER + "/" + Hangman::categoryToString(category) + ".hgqb";
+
+        return path;
+    }
+
+    // Compiles a bank per category from the database when it is missing or older than its TSV
+    void prepareQuestionBanks(Database& db, const std::string& dbPath) {
+        PROFILE_SCOPE("main::prepareQuestionBanks");
+
+        try {
+            if (ensureDirectoryExists(QUESTION_BANK_FOLDER) == false) std::filesystem::create_directories(QUESTION_BANK_FOLDER);
+
+            db.open(dbPath);
+
+            for (Category category : { Category::CSC_111, Category::CSC_211, Category::CSC_231 }) {
+                const std::string bankPath = getQuestionBankPath(category);
+                const std::string tsvPath = RESOURCES_FOLDER + "/" + Hangman::categoryToString(category) + ".tsv";
+
+                bool isStale = !std::filesystem::exists(bankPath);
+
+                if (!isStale && std::filesystem::exists(tsvPath)) isStale = std::filesystem::last_write_time(bankPath) < std::filesystem::last_write_time(tsvPath);
+
+                // Difficulties are taken when the bank is compiled, games played since then make them stale too
+                const long long timesAsked = db.getTimesAsked(category);
+
+                if (!isStale) {
+                    try {
+                        QuestionBank existing;
+                        existing.open(bankPath);
+
+                        isStale = existing.getTimesAsked() != static_cast<std::uint32_t>(timesAsked);
+                    }
+                    catch (const QuestionBankException&) {
+                        isStale = true;  // Older format or damaged, rebuilt below
+                    }
+                }
+
+                if (!isStale) continue;
+
+                // An edited TSV is imported first, otherwise the bank would be rebuilt from the old rows
+                if (std::filesystem::exists(tsvPath)) db.loadQuestionsFromTSV(tsvPath, Hangman::categoryToString(category));
+
+                // Compiled from the database rather than the TSV so question IDs match the statistics tables
+                QuestionBank::compile(db.getQuestions(category), bankPath, timesAsked);
+
+                // The whole file is only read back here, opening it for play checks the header alone
+                QuestionBank compiled;
+                compiled.open(bankPath);
+
+                if (!compiled.verifyChecksum()) throw std::runtime_error("Question bank is corrupt after compiling: " + bankPath);
+            }
+
+            db.close();
+        }
+        catch (const std::exception& err) {
+            db.close();
+            throw std::runtime_error("Question bank preparation failed: " + std::string(err.what()));
+        }
+    }
+
+    void exportSessions(const LaunchOptions& options) {
+        PROFILE_SCOPE("main::exportSessions");
+
+        if (!std::filesystem::exists(getDBPath())) throw std::runtime_error("No database to export from: " + getDBPath());
+
+        Database db;
+        db.open(getDBPath());
+
+        std::size_t rows = SessionExporter::exportSessions(db, options.exportPath, options.exportFormat);
+
+        db.close();
+        Display::showSuccess("Exported " + std::to_string(rows) + " game sessions to " + options.exportPath);
+    }
+
+    // Recomputes every category-mode top 10 from the stored sessions
+    void rebuildHighScores() {
+        PROFILE_SCOPE("main::rebuildHighScores");
+
+        if (!std::filesystem::exists(getDBPath())) throw std::runtime_error("No database to rebuild: " + getDBPath());
+
+        Database db;
+        db.open(getDBPath());
+        db.upgradeSchema();
+
+        std::size_t sessions = db.rebuildHighScores([](std::size_t read, std::size_t total) {
+            std::cout << "\rRebuilding high scores: " << read << " / " << total << " sessions" << std::flush;
+        });
+
+        std::cout << "\n";
+
+        db.close();
+        Display::showSuccess("Rebuilt high scores from " + std::to_string(sessions) + " game sessions");
+    }
+
+    /*
+    A named player's game logs SCORE_SAVED once its score is in the database. A game without it that
+    was not abandoned lost its score: the process died mid-game or before the save, or the save failed.
+    A finished game is saved with the score END_GAME logged, an unfinished one with its replayed score
+    as it stood when the process died. The missing events are appended so a second recovery skips the
+    game. Run it while no game is writing to the log, a game still being played looks the same.
+    */
+    void recoverUnsavedGames(const std::string& logPath, const std::vector<ReplayResult>& results) {
+        Database db;
+        db.open(getDBPath());
+        db.upgradeSchema();
+
+        GameLog log;
+        log.open(logPath);
+
+        int recovered = 0;
+
+        for (const ReplayResult& result : results) {
+            const LoggedGame& logged = result.game;
+
+            // Guests have nothing to save, their scores never reach the database
+            if (logged.isScoreSaved || logged.isAbandoned || (logged.playerId == -1)) continue;
+
+            // Only an unfinished game needs the replay for its score
+            if (!logged.isFinished && !result.error.empty()) continue;
+
+            int scoreCenti = logged.isFinished ? logged.loggedScoreCenti : result.replayedScoreCenti;
+
+            db.saveScore(logged.playerId, logged.category, logged.mode, scoreCenti);
+
+            if (!logged.isFinished) log.appendEndGame(logged.gameId, scoreCenti);
+
+            log.appendScoreSaved(logged.gameId);
+            recovered++;
+        }
+
+        log.close();
+        db.close();
+        Display::showSuccess("Recovered " + std::to_string(recovered) + " unsaved games into the high scores");
+    }
+
+    // Re-derives every logged game's score with the current rules and reports what changed
+    void replayEventLog(const LaunchOptions& options) {
+        PROFILE_SCOPE("main::replayEventLog");
+
+        if (!std::filesystem::exists(getDBPath())) throw std::runtime_error("No database to load questions from: " + getDBPath());
+
+        std::map<Category, std::vector<QuestionAnswer>> banks;
+
+        Database db;
+        db.open(getDBPath());
+
+        for (Category category : { Category::CSC_111, Category::CSC_211, Category::CSC_231 }) banks[category] = db.getQuestions(category);
+
+        db.close();
+
+        Hangman game;
+        applyAnswerMatching(game, options);
+
+        std::vector<ReplayResult> results = GameLog::replayScores(options.replayLogPath, banks, game);
+
+        int unfinished = 0;
+        int abandoned = 0;
+        int changed = 0;
+        int skipped = 0;
+
+        for (const ReplayResult& result : results) {
+            if (!result.error.empty()) {
+                Display::showError("Skipped game " + std::to_string(result.game.gameId) + ": " + result.error);
+                skipped++;
+            }
+            else if (result.game.isAbandoned) abandoned++;
+            else if (!result.game.isFinished) unfinished++;
+            else if (result.replayedScoreCenti != result.game.loggedScoreCenti) changed++;
+        }
+
+        Display::showSuccess("Replayed " + std::to_string(results.size() - skipped) + " games: " + std::to_string(unfinished) + " unfinished, "
+            + std::to_string(abandoned) + " abandoned, " + std::to_string(changed) + " finished games score differently under the current rules, "
+            + std::to_string(skipped) + " skipped");
+
+        if (options.recoverGames) recoverUnsavedGames(options.replayLogPath, results);
+    }
+
     Category stringToCategory(const std::string& str) {
         Category cat;
 
@@ -71,16 +489,87 @@ namespace {
         return cat;
     }
 
-    void handleGameplay(Hangman& game, Database& db, const std::string& playerName) {
+    // Per-store differences in how a finished game is recorded
+    void useCategory(Hangman&, SharedDatabase&, Category) {
+        // Every category is in the one database set up before play
+    }
+
+    void useCategory(Hangman& game, ShardedDatabase& shardedDb, Category category) {
+        game.setCurrentDbPath(shardedDb.getShardPath(category));
+    }
+
+    void saveQuestionStats(SharedDatabase& sharedDb, Category, const std::vector<QuestionStat>& stats) {
+        sharedDb.saveQuestionStats(stats);
+    }
+
+    void saveQuestionStats(ShardedDatabase& shardedDb, Category category, const std::vector<QuestionStat>& stats) {
+        shardedDb.saveQuestionStats(category, stats);
+    }
+
+    // Loads a category's questions on a pooled reader, so it can run on a background thread
+    template <typename Store>
+    std::vector<QuestionAnswer> loadQuestionSet(Store& sharedDb, Category category) {
+        return sharedDb.getQuestions(category);
+    }
+
+    // Maps a category's bank on first use, it then stays mapped for the rest of the session
+    std::shared_ptr<const QuestionBank> getQuestionBank(std::map<Category, std::shared_ptr<const QuestionBank>>& banks, Category category) {
+        std::shared_ptr<const QuestionBank>& bank = banks[category];
+
+        if (!bank) {
+            auto opened = std::make_shared<QuestionBank>();
+            opened->open(getQuestionBankPath(category));
+
+            bank = opened;
+        }
+
+        return bank;
+    }
+
+    /*
+    Next game's questions, loaded on a pooled reader from the end of a game while the game over screen
+    and the menus are shown. A load nobody takes is parked rather than waited for, so neither a game in
+    another category nor leaving the game blocks on it. Parked loads are a single query each and are
+    collected as they finish, the last ones when the session ends.
+    */
+    struct QuestionPrefetch {
+        std::future<std::vector<QuestionAnswer>> questions;
+        Category category = Category::CSC_111;
+        std::vector<std::future<std::vector<QuestionAnswer>>> parked;
+
+        void discard() {
+            if (questions.valid()) parked.push_back(std::move(questions));
+
+            parked.erase(std::remove_if(parked.begin(), parked.end(), [](const std::future<std::vector<QuestionAnswer>>& load) {
+                return load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }), parked.end());
+        }
+    };
+
+    // Store is a SharedDatabase for the single file or a ShardedDatabase for one file per category
+    template <typename Store>
+    void handleGameplay(Hangman& game, Store& sharedDb, QuestionPrefetch& prefetch, const std::string& playerName, bool useQuestionBank) {
         try {
             int playerId = -1;
 
+            // Mapped banks need no loading, the game reads the questions it draws straight from them
+            std::map<Category, std::shared_ptr<const QuestionBank>> banks;
+
+            // The game object is shared by everyone at this terminal, nothing of the previous player may carry over
+            game.resetPlayer();
+
             if (!playerName.empty()) {
                 try {
-                    db.open(getDBPath());
-                    playerId = db.addPlayer(playerName);
+                    playerId = sharedDb.addPlayer(playerName);
 
-                    if (playerId != -1) game.setCurrentPlayerId(playerId);
+                    if (playerId != -1) {
+                        game.setCurrentPlayerId(playerId);
+
+                        // Seed adaptive question selection from the player's history
+                        double averageScore = sharedDb.getAverageScore(playerId);
+
+                        if (averageScore >= 0.0) game.setPlayerSkill(averageScore / 100.0);
+                    }
                 }
                 catch (const DatabaseException& err) {
                     Display::showError("Database error during player addition: " + std::string(err.what()));
@@ -88,8 +577,6 @@ namespace {
                 catch (const std::exception& err) {
                     Display::showError("Unknown error during player addition: " + std::string(err.what()));
                 }
-
-                db.close();
             }
 
             while (true) {
@@ -118,68 +605,118 @@ namespace {
                 // Set up game
                 game.setGameMode(mode);
                 game.setCategory(category);
+                useCategory(game, sharedDb, category);
 
-                // Load questions
-                db.open(getDBPath());
+                // Load questions, reusing the prefetched set when the category is unchanged
+                if (useQuestionBank) {
+                    game.loadQuestions(getQuestionBank(banks, category));
+                }
+                else {
+                    std::vector<QuestionAnswer> questions;
+
+                    if (prefetch.questions.valid() && (prefetch.category == category)) {
+                        try {
+                            questions = prefetch.questions.get();
+                        }
+                        catch (const std::exception&) {
+                            questions.clear();  // Fall back to a direct load below
+                        }
+                    }
 
-                std::vector<QuestionAnswer> questions;
-                questions = db.getQuestions(category);
+                    prefetch.discard();
 
-                db.close();
+                    if (questions.empty()) questions = loadQuestionSet(sharedDb, category);
 
-                if (questions.empty()) throw std::runtime_error("No questions available for selected category");
+                    if (questions.empty()) throw std::runtime_error("No questions available for selected category");
 
-                game.loadQuestions(questions);
+                    game.loadQuestions(questions);
+                }
 
                 // Start game
                 if (!game.startGame()) throw std::runtime_error("Failed to start game");
 
-                // Main game loop
-                while (!game.isGameOver()) {
-                    const QuestionAnswer& currentQ = game.getCurrentQuestion();
+                // Main game loop, the engine asks for guesses until the game is over or the player quits
+                GameEngine<Hangman> engine(game);
+                std::string guess;
+                bool hasQuit = false;
 
-                    // Display game state
-                    if (mode == GameMode::CLASSIC) Display::showClassicGameState(game);
-                    else Display::showTestGameState(game);
+                auto readGuess = [&]() -> const std::string* {
+                    while (true) {
+                        // Display game state
+                        if (mode == GameMode::CLASSIC) Display::showClassicGameState(game);
+                        else Display::showTestGameState(game);
 
-                    // Get player's guess
-                    std::string guess;
-                    std::getline(std::cin, guess);
+                        // Get player's guess
+                        std::getline(std::cin, guess);
+
+                        if ((guess != "quit") && (guess != "exit")) return &guess;
 
-                    // Check for quit
-                    if ((guess == "quit") || (guess == "exit")) {
                         Display::showQuitConfirmation();
 
                         std::string confirm;
                         std::getline(std::cin, confirm);
 
                         if ((confirm == "y") || (confirm == "Y")) {
-                            game.resetGame();
-                            return;
+                            hasQuit = true;
+                            return nullptr;
                         }
-
-                        continue;
                     }
+                };
 
-                    // Process guess
-                    try {
-                        bool correct = false;
-                        correct = game.makeGuess(guess);
+                auto showResult = [mode](bool correct) {
+                    if (mode == GameMode::CLASSIC) Display::showGuessResult(correct);
+                };
 
-                        if (mode == GameMode::CLASSIC) Display::showGuessResult(correct);
+                while (!game.isGameOver() && !hasQuit) {
+                    try {
+                        engine.run(readGuess, showResult);
                     }
                     catch (const std::exception& err) {
                         Display::showError("Invalid guess: " + std::string(err.what()));
-                        continue;
                     }
                 }
 
-                // Game over - save score if player provided name
+                if (hasQuit) {
+                    game.resetGame();
+                    return;
+                }
+
+                try {
+                    game.endGame();
+                }
+                catch (const std::exception& err) {
+                    Display::showError("Failed to log end of game: " + std::string(err.what()));
+                }
+
+                // Game over - record per-question results for every game
+                try {
+                    saveQuestionStats(sharedDb, category, game.takeQuestionStats());
+                }
+                catch (const std::exception& err) {
+                    Display::showError("Failed to save question statistics: " + std::string(err.what()));
+                }
+
+                // Save score if player provided name
+                int playerRank = -1;
+                double percentile = -1.0;
+
                 if (playerId != -1) {
                     try {
-                        db.open(getDBPath());
-                        db.saveScore(playerId, Hangman::categoryToString(category), Hangman::gameModeToString(mode), game.getCurrentScore());
-                        db.close();
+                        sharedDb.saveScore(playerId, category, mode, game.getCurrentScoreCenti());
+
+                        // Until this is logged, --recover treats the score as lost
+                        if (game.getEventLog() != nullptr) {
+                            try {
+                                game.getEventLog()->appendScoreSaved();
+                            }
+                            catch (const std::exception& err) {
+                                Display::showError("Failed to log saved score: " + std::string(err.what()));
+                            }
+                        }
+
+                        // Standing among all players, shown on the game over screen
+                        playerRank = sharedDb.getPlayerRank(playerId, category, mode);
+                        percentile = sharedDb.getPercentile(game.getCurrentScoreCenti(), category, mode);
                     }
                     catch (const DatabaseException& err) {
                         Display::showError("Failed to save score: " + std::string(err.what()));
@@ -189,8 +726,15 @@ namespace {
                     }
                 }
 
+                // The game is over, the next one's questions load while its results are read
+                if (!useQuestionBank) {
+                    prefetch.discard();
+                    prefetch.category = category;
+                    prefetch.questions = std::async(std::launch::async, loadQuestionSet<Store>, std::ref(sharedDb), category);
+                }
+
                 // Show final results
-                Display::showGameOver(game);
+                Display::showGameOver(game, playerRank, percentile);
 
                 // Ask to play again
                 Display::showPlayAgainPrompt();
@@ -205,23 +749,78 @@ namespace {
             Display::showError("Game error: " + std::string(err.what()));
         }
     }
-}
 
-int main() {
-    int exitStatus = 0;
+    // Interactive console session, from the welcome screen until the player quits
+    void playGame(const LaunchOptions& options) {
+        PROFILE_SCOPE("main::playGame");
 
-    try {
         // Initialize game components
         Database db;
-        Hangman game;
+
+        // The console front end drives Hangman, other registered games need their own
+        std::unique_ptr<QuizGame> createdGame = GameRegistry::create(options.gameName);
+        Hangman* hangman = dynamic_cast<Hangman*>(createdGame.get());
+
+        if (hangman == nullptr) throw std::runtime_error("The console interface cannot run " + options.gameName);
+
+        Hangman& game = *hangman;
+
+        db.setQueryProfiling(options.enableQueryProfiling);
+        game.setSelectionPolicy(options.selectionPolicy);
+
+        applyAnswerMatching(game, options);
 
         // Set up console and display welcome
         Display::initializeConsole();
         Display::showWelcome();
 
-        // Initialize database
-        initializeDatabase(db);
-        game.setCurrentDbPath(getDBPath());
+        // Gameplay reads and writes share these connections across threads, one set per file when sharded
+        std::unique_ptr<SharedDatabase> sharedDb;
+        std::unique_ptr<ShardedDatabase> shardedDb;
+
+        // Declared after the connections it reads from, so its loads finish before they close
+        QuestionPrefetch prefetch;
+
+        // In-memory play is written back to the database file by this job
+        SnapshotScheduler snapshots;
+
+        const std::string dbPath = (options.snapshotSeconds > 0) ? Database::MEMORY_DB_PATH : getDBPath();
+
+        if (options.sharded) {
+            shardedDb = initializeShards(options);
+        }
+        else {
+            if (options.snapshotSeconds > 0) initializeMemoryDatabase(db, snapshots, options);
+            else initializeDatabase(db);
+
+            game.setCurrentDbPath(dbPath);
+
+            if (options.useQuestionBank) prepareQuestionBanks(db, dbPath);
+
+            sharedDb = std::make_unique<SharedDatabase>(dbPath, READER_COUNT, options.enableQueryProfiling);
+        }
+
+        // Old sessions are rolled up in the background while the menus are up
+        SessionCompactor compactor;
+
+        if (options.retentionDays > 0) compactor.start(dbPath, options.retentionDays);
+
+        // Hot backups of the database file, in memory mode that is the latest snapshot
+        BackupScheduler backups;
+
+        if (options.backupMinutes > 0) backups.start(getDBPath(), BACKUP_FOLDER, std::chrono::minutes(options.backupMinutes));
+
+        // Every game event is appended to the log while it is open
+        GameLog eventLog;
+
+        if (!options.eventLogPath.empty()) {
+            std::filesystem::path logFolder = std::filesystem::path(options.eventLogPath).parent_path();
+
+            if (!logFolder.empty() && (ensureDirectoryExists(logFolder.string()) == false)) std::filesystem::create_directories(logFolder);
+
+            eventLog.open(options.eventLogPath);
+            game.setEventLog(&eventLog);
+        }
 
         while (true) {
             std::string choice;
@@ -236,15 +835,15 @@ int main() {
                 std::string playerName = "";
                 std::getline(std::cin, playerName);
 
-                handleGameplay(game, db, playerName);
+                if (shardedDb) handleGameplay(game, *shardedDb, prefetch, playerName, options.useQuestionBank);
+                else handleGameplay(game, *sharedDb, prefetch, playerName, options.useQuestionBank);
             }
             else if (choice == "2") {  // About section
                 Display::showAbout();
             }
             else if (choice == "3") {  // High Scores
-                db.open(getDBPath());
-                Display::showHighScores(db);
-                db.close();
+                if (shardedDb) Display::showHighScores(*shardedDb, options.leaderboardWindow);
+                else Display::showHighScores(*sharedDb, options.leaderboardWindow);
             }
             else if (choice == "4") {  // Quit game
                 break;
@@ -254,6 +853,45 @@ int main() {
             }
         }
 
+        compactor.stop();
+
+        if (!compactor.getError().empty()) Display::showError("Session compaction failed: " + compactor.getError());
+
+        backups.stop();
+
+        if (!backups.getError().empty()) Display::showError("Database backup failed: " + backups.getError());
+
+        snapshots.stop();
+
+        if (!snapshots.getError().empty()) Display::showError("Saving the in-memory database failed: " + snapshots.getError());
+
+        // Write the per-statement SQL report
+        if (db.isQueryProfilingEnabled()) {
+            if (shardedDb) shardedDb->collectStatistics(db);
+            else sharedDb->collectStatistics(db);
+
+            std::ofstream reportFile(options.queryProfileOutputPath);
+
+            if (reportFile) reportFile << db.getQueryProfileReport();
+            else Display::showError("Could not open SQL profile output file: " + options.queryProfileOutputPath);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int exitStatus = 0;
+
+    try {
+        LaunchOptions options = parseArguments(argc, argv);
+
+        if (options.enableProfiling) Profiler::enable(options.profileFormat, options.profileOutputPath);
+
+        // Export, rebuild and replay modes run without the interactive game
+        if (!options.exportPath.empty()) exportSessions(options);
+        else if (options.rebuildHighScores) rebuildHighScores();  // For when High_Scores has drifted or the scoring rules changed
+        else if (!options.replayLogPath.empty()) replayEventLog(options);
+        else playGame(options);
+
         exitStatus = EXIT_SUCCESS;
     }
     catch (const std::exception& err) {
@@ -262,6 +900,14 @@ int main() {
         exitStatus = EXIT_FAILURE;
     }
 
+    // Write recorded timings on exit
+    try {
+        if (Profiler::isEnabled()) Profiler::dump();
+    }
+    catch (const std::exception& err) {
+        Display::showError("Failed to write profile: " + std::string(err.what()));
+    }
+
     return exitStatus;
 }
 